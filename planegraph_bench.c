@@ -0,0 +1,714 @@
+/*
+ * Main developer: Nico Van Cleemput
+ * 
+ * Copyright (C) 2019 Nico Van Cleemput.
+ * Licensed under the GNU GPL, read the file LICENSE.txt for details.
+ */
+
+/* Benchmarks for the plane graph library. The graphs are generated by this
+ * program, so no input is needed and the workloads are the same on each run.
+ */
+
+#include "planegraphs_base.h"
+#include "planegraphs_input.h"
+#include "planegraphs_output.h"
+#include "planegraphs_automorphismgroup.h"
+#include "planegraphs_cycles.h"
+#include "planegraphs_connectivity.h"
+#include "planegraphs_mutation.h"
+#include "planegraphs_stats.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <unistd.h>
+
+//----------------GENERATORS--------------------
+
+/* The graphs are generated as straight line drawings: the rotation at each
+ * vertex is obtained by sorting the neighbours by angle.
+ */
+typedef struct __drawing {
+    int nv;
+    double *x;
+    double *y;
+    int *degree;
+    int **neighbours;
+    int maximum_degree;
+} DRAWING;
+
+static DRAWING *new_drawing(int nv, int maximum_degree){
+    DRAWING *drawing = (DRAWING *)malloc(sizeof(DRAWING));
+    drawing->nv = nv;
+    drawing->maximum_degree = maximum_degree;
+    drawing->x = (double *)malloc(sizeof(double) * nv);
+    drawing->y = (double *)malloc(sizeof(double) * nv);
+    drawing->degree = (int *)calloc(nv, sizeof(int));
+    drawing->neighbours = (int **)malloc(sizeof(int *) * nv);
+    for(int i = 0; i < nv; i++){
+        drawing->neighbours[i] = (int *)malloc(sizeof(int) * maximum_degree);
+    }
+    return drawing;
+}
+
+static void free_drawing(DRAWING *drawing){
+    for(int i = 0; i < drawing->nv; i++){
+        free(drawing->neighbours[i]);
+    }
+    free(drawing->neighbours);
+    free(drawing->degree);
+    free(drawing->x);
+    free(drawing->y);
+    free(drawing);
+}
+
+static void add_drawing_edge(DRAWING *drawing, int u, int v){
+    drawing->neighbours[u][drawing->degree[u]++] = v;
+    drawing->neighbours[v][drawing->degree[v]++] = u;
+}
+
+static DRAWING *sorted_drawing;
+static int sorted_vertex;
+
+static int compare_angles(const void *a, const void *b){
+    int u = *(const int *)a, v = *(const int *)b;
+    double x = sorted_drawing->x[sorted_vertex], y = sorted_drawing->y[sorted_vertex];
+    double angle_u = atan2(sorted_drawing->y[u] - y, sorted_drawing->x[u] - x);
+    double angle_v = atan2(sorted_drawing->y[v] - y, sorted_drawing->x[v] - x);
+    return (angle_u < angle_v) - (angle_u > angle_v);
+}
+
+static PLANE_GRAPH *drawing_to_plane_graph(DRAWING *drawing){
+    int i, j, length = 1;
+    DEFAULT_PG_INPUT_OPTIONS(options);
+    options.construct_faces = TRUE;
+    
+    for(i = 0; i < drawing->nv; i++){
+        length += drawing->degree[i] + 1;
+    }
+    unsigned short *code = (unsigned short *)malloc(sizeof(unsigned short) * length);
+    
+    sorted_drawing = drawing;
+    length = 0;
+    code[length++] = drawing->nv;
+    for(i = 0; i < drawing->nv; i++){
+        sorted_vertex = i;
+        qsort(drawing->neighbours[i], drawing->degree[i], sizeof(int), compare_angles);
+        for(j = 0; j < drawing->degree[i]; j++){
+            code[length++] = drawing->neighbours[i][j] + 1;
+        }
+        code[length++] = 0;
+    }
+    
+    PLANE_GRAPH *pg = decode_planar_code(code, &options);
+    free(code);
+    return pg;
+}
+
+/* A simple linear congruential generator, so that the generated graphs are
+ * the same on each platform.
+ */
+static unsigned long long random_state;
+
+static int next_random(int bound){
+    random_state = random_state * 6364136223846793005ULL + 1442695040888963407ULL;
+    return (int)((random_state >> 33) % bound);
+}
+
+/**
+ * The tube C_k x P_m drawn as m concentric cycles of length k, i.e., a
+ * quadrangulated cylinder closed by two k-gons. If holes is positive, then
+ * that number of randomly chosen edges between consecutive cycles in the middle
+ * third of the tube is removed, which gives a graph that looks locally 
+ * symmetric nearly everywhere, but has a trivial automorphism group.
+ */
+static PLANE_GRAPH *tube(int k, int m, int holes){
+    int i, j;
+    DRAWING *drawing = new_drawing(k*m, 4);
+    
+    for(j = 0; j < m; j++){
+        for(i = 0; i < k; i++){
+            drawing->x[j*k + i] = (j + 1) * cos(2*M_PI*i/k);
+            drawing->y[j*k + i] = (j + 1) * sin(2*M_PI*i/k);
+            add_drawing_edge(drawing, j*k + i, j*k + (i + 1) % k);
+        }
+    }
+    
+    //choose the removed edges such that no vertex loses two edges
+    char *removed = (char *)calloc(k*m, sizeof(char));
+    char *used = (char *)calloc(k*m, sizeof(char));
+    random_state = 42;
+    for(int h = 0; h < holes && h < k*(m/3)/4; ){
+        int v = (m/3)*k + next_random(k*(m/3));
+        if(!used[v] && !used[v + k]){
+            removed[v] = used[v] = used[v + k] = 1;
+            h++;
+        }
+    }
+    for(j = 0; j < m - 1; j++){
+        for(i = 0; i < k; i++){
+            if(!removed[j*k + i]){
+                add_drawing_edge(drawing, j*k + i, (j + 1)*k + i);
+            }
+        }
+    }
+    free(removed);
+    free(used);
+    
+    PLANE_GRAPH *pg = drawing_to_plane_graph(drawing);
+    free_drawing(drawing);
+    return pg;
+}
+
+/**
+ * The antiprism with two k-gons.
+ */
+static PLANE_GRAPH *antiprism(int k){
+    DRAWING *drawing = new_drawing(2*k, 4);
+    
+    for(int i = 0; i < k; i++){
+        drawing->x[i] = cos(2*M_PI*i/k);
+        drawing->y[i] = sin(2*M_PI*i/k);
+        drawing->x[k + i] = 2*cos(2*M_PI*(i + 0.5)/k);
+        drawing->y[k + i] = 2*sin(2*M_PI*(i + 0.5)/k);
+    }
+    for(int i = 0; i < k; i++){
+        add_drawing_edge(drawing, i, (i + 1) % k);
+        add_drawing_edge(drawing, k + i, k + (i + 1) % k);
+        add_drawing_edge(drawing, i, k + i);
+        add_drawing_edge(drawing, (i + 1) % k, k + i);
+    }
+    
+    PLANE_GRAPH *pg = drawing_to_plane_graph(drawing);
+    free_drawing(drawing);
+    return pg;
+}
+
+//the rotation around each vertex of the icosahedron
+static const int icosahedron_neighbours[12][5] = {
+    {6, 2, 1, 7, 5}, {3, 7, 0, 2, 8}, {8, 1, 0, 6, 4}, {11, 7, 1, 8, 9},
+    {9, 8, 2, 6, 10}, {10, 6, 0, 7, 11}, {4, 2, 0, 5, 10}, {11, 5, 0, 1, 3},
+    {9, 3, 1, 2, 4}, {10, 11, 3, 8, 4}, {11, 9, 4, 6, 5}, {5, 7, 3, 9, 10}
+};
+
+/**
+ * The icosahedron with its faces constructed, in a graph with room for a
+ * triangulation with maxn vertices.
+ */
+static PLANE_GRAPH *icosahedron(int maxn){
+    unsigned short code[1 + 12*6];
+    int length = 0;
+    DEFAULT_PG_INPUT_OPTIONS(options);
+    options.construct_faces = TRUE;
+    
+    code[length++] = 12;
+    for(int i = 0; i < 12; i++){
+        for(int j = 0; j < 5; j++){
+            code[length++] = icosahedron_neighbours[i][j] + 1;
+        }
+        code[length++] = 0;
+    }
+    
+    PLANE_GRAPH *ico = decode_planar_code(code, &options);
+    PLANE_GRAPH *pg = new_plane_graph(maxn, 0);
+    copy_plane_graph(pg, ico);
+    free_plane_graph(ico);
+    return pg;
+}
+
+/**
+ * Splits the edge e of a triangulation by a new vertex that is also connected
+ * to the two vertices opposite to e, so the result is again a triangulation.
+ */
+static void split_edge(PLANE_GRAPH *pg, PG_EDGE *e){
+    PG_EDGE *inverse = e->inverse;
+    subdivide_edge(pg, e);
+    //the new vertex has two edges: one back to the start of e and one to its end
+    PG_EDGE *to_start = e->inverse;
+    PG_EDGE *to_end = inverse->inverse;
+    //the face on the right of e is the quadrangle u, x, v, w
+    PG_EDGE *w_u = to_end->inverse->prev->inverse->prev;
+    insert_edge(pg, to_end, w_u);
+    //the face on the left of e is the quadrangle x, u, y, v
+    PG_EDGE *y_v = to_start->inverse->prev->inverse->prev;
+    insert_edge(pg, to_start, y_v);
+}
+
+/**
+ * A random triangulation with n vertices: starting from the icosahedron,
+ * randomly chosen edges are split, after which n random edges are flipped.
+ */
+static PLANE_GRAPH *random_triangulation(int n, unsigned long long seed){
+    PLANE_GRAPH *pg = icosahedron(n);
+    random_state = seed;
+    while(pg->nv < n){
+        split_edge(pg, pg->edges + next_random(pg->ne));
+    }
+    for(int i = 0; i < n; i++){
+        flip_edge(pg, pg->edges + next_random(pg->ne));
+    }
+    return pg;
+}
+
+/**
+ * Replaces each triangle of a triangulation by four triangles: each edge is
+ * subdivided, and the new vertices in each face are connected to each other.
+ */
+static void refine_triangulation(PLANE_GRAPH *pg){
+    int nv = pg->nv, ne = pg->ne, nf = pg->nf;
+    
+    //subdivided edges keep their position and end at a new vertex
+    for(int i = 0; i < ne; i++){
+        if(pg->edges[i].end < nv){
+            subdivide_edge(pg, pg->edges + i);
+        }
+    }
+    
+    //each old face is now the hexagon u, a, v, b, w, c
+    for(int f = 0; f < nf; f++){
+        PG_EDGE *u_a = pg->face_start[f];
+        if(u_a->start >= nv){
+            u_a = u_a->inverse->prev;
+        }
+        PG_EDGE *a_v = u_a->inverse->prev;
+        PG_EDGE *v_b = a_v->inverse->prev;
+        PG_EDGE *b_w = v_b->inverse->prev;
+        PG_EDGE *w_c = b_w->inverse->prev;
+        PG_EDGE *c_u = w_c->inverse->prev;
+        PG_EDGE *c_a = insert_edge(pg, c_u, a_v);
+        insert_edge(pg, a_v, b_w);
+        insert_edge(pg, b_w, c_a);
+    }
+}
+
+/**
+ * The geodesic triangulation obtained by refining the icosahedron the given
+ * number of times. All vertices have degree 6, except for 12 vertices of
+ * degree 5, so its dual is a fullerene.
+ */
+static PLANE_GRAPH *geodesic_triangulation(int refinements){
+    int n = 12;
+    for(int i = 0; i < refinements; i++){
+        n = 4*n - 6;
+    }
+    PLANE_GRAPH *pg = icosahedron(n);
+    for(int i = 0; i < refinements; i++){
+        refine_triangulation(pg);
+    }
+    return pg;
+}
+
+/**
+ * Returns the dual of the graph and frees the graph.
+ */
+static PLANE_GRAPH *replace_by_dual(PLANE_GRAPH *pg){
+    PLANE_GRAPH *dual = get_dual_graph(pg);
+    free_plane_graph(pg);
+    return dual;
+}
+
+/**
+ * The wheel with k spokes. The code is written directly, since sorting the
+ * neighbours of the hub by angle is not needed.
+ */
+static PLANE_GRAPH *wheel(int k){
+    unsigned short *code = (unsigned short *)malloc(sizeof(unsigned short) * (1 + k + 1 + 4*k));
+    int length = 0;
+    DEFAULT_PG_INPUT_OPTIONS(options);
+    options.construct_faces = TRUE;
+    
+    //the hub is vertex 1, and the vertices of the rim are 2 up to k + 1
+    code[length++] = k + 1;
+    for(int i = k - 1; i >= 0; i--){
+        code[length++] = 2 + i;
+    }
+    code[length++] = 0;
+    for(int i = 0; i < k; i++){
+        code[length++] = 1;
+        code[length++] = 2 + (i + 1) % k;
+        code[length++] = 2 + (i + k - 1) % k;
+        code[length++] = 0;
+    }
+    
+    PLANE_GRAPH *pg = decode_planar_code(code, &options);
+    free(code);
+    return pg;
+}
+
+//----------------BENCHMARKS--------------------
+
+static double now(){
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return time.tv_sec + time.tv_nsec * 1e-9;
+}
+
+static void benchmark_automorphisms(const char *name, PLANE_GRAPH *pg, int repeats, int thread_count){
+    int i, size = 0, generators_size = 0, count_size = 0, parallel_size = 0;
+    
+    double start = now();
+    for(i = 0; i < repeats; i++){
+        PG_AUTOMORPHISM_GROUP *aut = determine_automorphisms(pg);
+        size = aut->size;
+        free_automorphism_group(aut);
+    }
+    double full = (now() - start) / repeats;
+    
+    start = now();
+    for(i = 0; i < repeats; i++){
+        PG_AUTOMORPHISM_GROUP *aut = determine_automorphisms_parallel(pg, thread_count);
+        parallel_size = aut->size;
+        free_automorphism_group(aut);
+    }
+    double parallel = (now() - start) / repeats;
+    
+    start = now();
+    for(i = 0; i < repeats; i++){
+        PG_AUTOMORPHISM_GROUP *aut = determine_automorphism_generators(pg);
+        generators_size = aut->size;
+        free_automorphism_group(aut);
+    }
+    double generators = (now() - start) / repeats;
+    
+    PG_AUT_COMP_DATA *workspace = new_automorphism_computation_workspace();
+    start = now();
+    for(i = 0; i < repeats; i++){
+        count_size = count_automorphisms(pg, 0, NULL, NULL, workspace);
+    }
+    double count = (now() - start) / repeats;
+    free_automorphism_computation_workspace(workspace);
+    
+    if(size != generators_size || size != count_size || size != parallel_size){
+        fprintf(stderr, "%s: group sizes differ (%d, %d, %d and %d).\n", name, size, parallel_size,
+                generators_size, count_size);
+    }
+    
+    printf("%-24s nv=%-7d ne=%-7d |Aut|=%-7d all=%10.3f ms  parallel=%10.3f ms  generators=%10.3f ms  count=%10.3f ms\n",
+           name, pg->nv, pg->ne, size, 1000*full, 1000*parallel, 1000*generators, 1000*count);
+}
+
+//----------------SUITE--------------------
+
+/* The suite runs each operation a number of times on each generated graph, and
+ * reports the throughput and the distribution of the time of a single call.
+ */
+typedef struct __benchmark_graph {
+    const char *family;
+    int parameter;
+    PLANE_GRAPH *pg;
+    
+    //the planar code of the graph, as used by decode_planar_code
+    unsigned short *code;
+    //the number of bytes of the planar code in a file
+    size_t code_size;
+} BENCHMARK_GRAPH;
+
+//the results of the operations are accumulated, so no call can be optimised away
+static long long checksum = 0;
+//the output of write_planar_code is discarded
+static FILE *null_file;
+
+static void benchmark_decode(BENCHMARK_GRAPH *graph){
+    DEFAULT_PG_INPUT_OPTIONS(options);
+    PLANE_GRAPH *pg = decode_planar_code(graph->code, &options);
+    checksum += pg->ne;
+    free_plane_graph(pg);
+}
+
+static void benchmark_write(BENCHMARK_GRAPH *graph){
+    write_planar_code(graph->pg, null_file, FALSE);
+}
+
+static void benchmark_construct_faces(BENCHMARK_GRAPH *graph){
+    construct_faces(graph->pg);
+    checksum += graph->pg->nf;
+}
+
+static void benchmark_dual(BENCHMARK_GRAPH *graph){
+    PLANE_GRAPH *dual = get_dual_graph(graph->pg);
+    checksum += dual->nv;
+    free_plane_graph(dual);
+}
+
+static void benchmark_determine_automorphisms(BENCHMARK_GRAPH *graph){
+    PG_AUTOMORPHISM_GROUP *aut = determine_automorphisms(graph->pg);
+    checksum += aut->size;
+    free_automorphism_group(aut);
+}
+
+static void benchmark_shortest_cycle(BENCHMARK_GRAPH *graph){
+    checksum += shortest_cycle(graph->pg);
+}
+
+static void benchmark_edge_connectivity(BENCHMARK_GRAPH *graph){
+    checksum += edge_connectivity(graph->pg);
+}
+
+typedef struct __benchmark_operation {
+    const char *name;
+    void (*run)(BENCHMARK_GRAPH *graph);
+    //TRUE if the throughput in bytes of planar code is meaningful
+    boolean counts_bytes;
+} BENCHMARK_OPERATION;
+
+static const BENCHMARK_OPERATION operations[] = {
+    {"decode_planar_code", benchmark_decode, TRUE},
+    {"write_planar_code", benchmark_write, TRUE},
+    {"construct_faces", benchmark_construct_faces, FALSE},
+    {"get_dual_graph", benchmark_dual, FALSE},
+    {"determine_automorphisms", benchmark_determine_automorphisms, FALSE},
+    {"shortest_cycle", benchmark_shortest_cycle, FALSE},
+    {"edge_connectivity", benchmark_edge_connectivity, FALSE}
+};
+
+#define OPERATION_COUNT (sizeof(operations)/sizeof(operations[0]))
+
+/**
+ * Generates a graph of the given family. The parameter is the number of
+ * vertices, except for fullerenes where it is the number of refinements of
+ * the icosahedron, and for grids where it is the length of the sides.
+ */
+static PLANE_GRAPH *generate_graph(const char *family, int parameter){
+    if(strcmp(family, "triangulation") == 0){
+        return random_triangulation(parameter, 1000003ULL*parameter);
+    } else if(strcmp(family, "cubic") == 0){
+        return replace_by_dual(random_triangulation(parameter/2 + 2, 1000033ULL*parameter));
+    } else if(strcmp(family, "fullerene") == 0){
+        return replace_by_dual(geodesic_triangulation(parameter));
+    } else if(strcmp(family, "grid") == 0){
+        return tube(parameter, parameter, 0);
+    } else {
+        return wheel(parameter - 1);
+    }
+}
+
+static void prepare_benchmark_graph(BENCHMARK_GRAPH *graph, const char *family, int parameter){
+    graph->family = family;
+    graph->parameter = parameter;
+    graph->pg = generate_graph(family, parameter);
+    if(!graph->pg->faces_constructed){
+        construct_faces(graph->pg);
+    }
+    
+    PLANE_GRAPH *pg = graph->pg;
+    int length = 0;
+    graph->code = (unsigned short *)malloc(sizeof(unsigned short) * (1 + pg->nv + pg->ne));
+    graph->code[length++] = pg->nv;
+    for(int i = 0; i < pg->nv; i++){
+        PG_EDGE *e, *elast;
+        e = elast = pg->first_edge[i];
+        do {
+            graph->code[length++] = e->end + 1;
+            e = e->next;
+        } while (e != elast);
+        graph->code[length++] = 0;
+    }
+    graph->code_size = planar_code_size(pg);
+}
+
+static int compare_times(const void *a, const void *b){
+    double t1 = *(const double *)a, t2 = *(const double *)b;
+    return (t1 > t2) - (t1 < t2);
+}
+
+/**
+ * Returns the time below which the given fraction of the sorted times lies.
+ */
+static double percentile(double *sorted_times, int count, double fraction){
+    int i = (int)ceil(fraction * count) - 1;
+    return sorted_times[i < 0 ? 0 : i];
+}
+
+//slow operations are repeated less often than requested once they have run
+//for this number of seconds, but at least MINIMUM_RUNS times
+#define TIME_BUDGET 2.0
+#define MINIMUM_RUNS 5
+
+static void benchmark_operation(BENCHMARK_GRAPH *graph, const BENCHMARK_OPERATION *operation,
+        int repeats, boolean machine_readable){
+    double *times = (double *)malloc(sizeof(double) * repeats);
+    
+    //the first call is not timed, so the caches are warm for each timed call
+    operation->run(graph);
+    double total = 0;
+    int runs = 0;
+    while(runs < repeats && (runs < MINIMUM_RUNS || total < TIME_BUDGET)){
+        double start = now();
+        operation->run(graph);
+        times[runs] = now() - start;
+        total += times[runs];
+        runs++;
+    }
+    repeats = runs;
+    qsort(times, repeats, sizeof(double), compare_times);
+    
+    double mean = total / repeats;
+    double calls_per_second = repeats / total;
+    double megabytes_per_second = operation->counts_bytes ? graph->code_size * calls_per_second / 1e6 : 0;
+    
+    if(machine_readable){
+        printf("%s,%d,%d,%d,%s,%d,%.3f,%.3f,%.3f,%.3f,%.3f,%.1f,%.3f\n",
+               graph->family, graph->parameter, graph->pg->nv, graph->pg->ne/2, operation->name, repeats,
+               1e6*mean, 1e6*percentile(times, repeats, 0.5), 1e6*percentile(times, repeats, 0.9),
+               1e6*percentile(times, repeats, 0.99), 1e6*times[repeats - 1],
+               calls_per_second, megabytes_per_second);
+    } else {
+        printf("%-14s %7d %7d %-24s %11.1f %11.1f %11.1f %11.1f %11.1f %11.1f",
+               graph->family, graph->pg->nv, graph->pg->ne/2, operation->name,
+               1e6*mean, 1e6*percentile(times, repeats, 0.5), 1e6*percentile(times, repeats, 0.9),
+               1e6*percentile(times, repeats, 0.99), 1e6*times[repeats - 1], calls_per_second);
+        if(operation->counts_bytes){
+            printf(" %9.1f MB/s", megabytes_per_second);
+        }
+        printf("\n");
+    }
+    
+    free(times);
+}
+
+static void run_suite(int repeats, boolean quick, boolean machine_readable){
+    //the sizes are chosen such that the planar code uses 2 bytes per entry at most
+    static const struct {
+        const char *family;
+        int parameters[3];
+    } workloads[] = {
+        {"triangulation", {100, 1000, 10000}},
+        {"cubic", {100, 1000, 10000}},
+        {"fullerene", {2, 3, 5}},
+        {"grid", {10, 32, 100}},
+        {"wheel", {100, 1000, 3000}}
+    };
+    int size_count = quick ? 1 : 3;
+    
+    null_file = fopen("/dev/null", "w");
+    if(null_file == NULL){
+        fprintf(stderr, "Could not open /dev/null.\n");
+        exit(EXIT_FAILURE);
+    }
+    
+    if(machine_readable){
+        printf("family,parameter,nv,edges,operation,runs,mean_us,p50_us,p90_us,p99_us,max_us,calls_per_s,mb_per_s\n");
+    } else {
+        printf("%-14s %7s %7s %-24s %11s %11s %11s %11s %11s %11s\n",
+               "family", "nv", "edges", "operation", "mean (us)", "p50 (us)", "p90 (us)", "p99 (us)",
+               "max (us)", "calls/s");
+    }
+    
+    for(size_t w = 0; w < sizeof(workloads)/sizeof(workloads[0]); w++){
+        for(int i = 0; i < size_count; i++){
+            BENCHMARK_GRAPH graph;
+            prepare_benchmark_graph(&graph, workloads[w].family, workloads[w].parameters[i]);
+            for(size_t o = 0; o < OPERATION_COUNT; o++){
+                benchmark_operation(&graph, operations + o, repeats, machine_readable);
+            }
+            fflush(stdout);
+            free(graph.code);
+            free_plane_graph(graph.pg);
+        }
+    }
+    
+    fclose(null_file);
+    //printing the checksum makes sure the results of the operations are used
+    fprintf(stderr, "checksum: %lld\n", checksum);
+}
+
+static void help(char *name){
+    fprintf(stderr, "Usage: %s [options]\n\n", name);
+    fprintf(stderr, "Runs the benchmark suite: decoding, writing, faces, dual, automorphisms,\n");
+    fprintf(stderr, "girth and edge connectivity on generated triangulations, cubic graphs,\n");
+    fprintf(stderr, "fullerenes, grids and wheels of several sizes.\n\n");
+    fprintf(stderr, "Valid options:\n");
+    fprintf(stderr, "  -a    Compare the automorphism computations instead of running the suite.\n");
+    fprintf(stderr, "  -m    Machine-readable output: comma separated values with a header.\n");
+    fprintf(stderr, "  -q    Quick run: only use the smallest graph of each family.\n");
+    fprintf(stderr, "  -r n  Repeat each benchmark n times (default: 3 for -a and 25 otherwise).\n");
+    fprintf(stderr, "        In the suite an operation stops early once it has run 5 times and\n");
+    fprintf(stderr, "        for at least 2 seconds.\n");
+    fprintf(stderr, "  -s    Print the counters of the library to stderr at the end. This requires\n");
+    fprintf(stderr, "        a library that was compiled with PG_STATS defined.\n");
+    fprintf(stderr, "  -t n  Use n threads for the parallel benchmarks of -a (default: 4).\n");
+    fprintf(stderr, "  -h    Print this help and return.\n");
+}
+
+static void run_automorphism_benchmarks(int repeats, int thread_count){
+    char name[64];
+    
+    //symmetric graphs
+    int antiprism_sizes[] = {100, 1000};
+    for(int i = 0; i < 2; i++){
+        PLANE_GRAPH *pg = antiprism(antiprism_sizes[i]);
+        sprintf(name, "antiprism(%d)", antiprism_sizes[i]);
+        benchmark_automorphisms(name, pg, repeats, thread_count);
+        free_plane_graph(pg);
+    }
+    int tube_sizes[][2] = {{20, 20}, {60, 60}};
+    for(int i = 0; i < 2; i++){
+        PLANE_GRAPH *pg = tube(tube_sizes[i][0], tube_sizes[i][1], 0);
+        sprintf(name, "tube(%d,%d)", tube_sizes[i][0], tube_sizes[i][1]);
+        benchmark_automorphisms(name, pg, repeats, thread_count);
+        free_plane_graph(pg);
+    }
+    
+    //near-symmetric graphs: locally symmetric, but with a trivial group
+    int holed_tube_sizes[][3] = {{50, 50, 60}, {150, 100, 200}, {300, 200, 400}};
+    for(int i = 0; i < 3; i++){
+        PLANE_GRAPH *pg = tube(holed_tube_sizes[i][0], holed_tube_sizes[i][1], holed_tube_sizes[i][2]);
+        sprintf(name, "holed_tube(%d,%d,%d)", holed_tube_sizes[i][0], holed_tube_sizes[i][1], holed_tube_sizes[i][2]);
+        benchmark_automorphisms(name, pg, repeats, thread_count);
+        free_plane_graph(pg);
+    }
+}
+
+int main(int argc, char *argv[]){
+    int repeats = 0;
+    int thread_count = 4;
+    boolean automorphisms_only = FALSE;
+    boolean machine_readable = FALSE;
+    boolean quick = FALSE;
+    boolean print_stats = FALSE;
+    int c;
+    
+    while((c = getopt(argc, argv, "amqr:st:h")) != -1){
+        switch(c){
+            case 'a':
+                automorphisms_only = TRUE;
+                break;
+            case 'm':
+                machine_readable = TRUE;
+                break;
+            case 'q':
+                quick = TRUE;
+                break;
+            case 'r':
+                repeats = atoi(optarg);
+                break;
+            case 's':
+                print_stats = TRUE;
+                break;
+            case 't':
+                thread_count = atoi(optarg);
+                break;
+            case 'h':
+                help(argv[0]);
+                return EXIT_SUCCESS;
+            default:
+                help(argv[0]);
+                return EXIT_FAILURE;
+        }
+    }
+    
+    if(automorphisms_only){
+        run_automorphism_benchmarks(repeats > 0 ? repeats : 3, thread_count);
+    } else {
+        run_suite(repeats > 0 ? repeats : 25, quick, machine_readable);
+    }
+    
+    if(print_stats){
+        PG_STATS_SNAPSHOT stats;
+        get_plane_graph_stats(&stats);
+        print_plane_graph_stats(stderr, &stats);
+    }
+    
+    return EXIT_SUCCESS;
+}
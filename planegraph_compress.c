@@ -0,0 +1,59 @@
+/*
+ * Main developer: Nico Van Cleemput
+ * 
+ * Copyright (C) 2019 Nico Van Cleemput.
+ * Licensed under the GNU GPL, read the file LICENSE.txt for details.
+ */
+
+/* Converts plane graphs between planar code and compressed planar code. The
+ * graphs are read from stdin and written to stdout.
+ */
+
+#include "planegraphs_base.h"
+#include "planegraphs_input.h"
+#include "planegraphs_output.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+static void help(char *name){
+    fprintf(stderr, "Usage: %s [options] < input > output\n\n", name);
+    fprintf(stderr, "Converts planar code to compressed planar code.\n\n");
+    fprintf(stderr, "Valid options:\n");
+    fprintf(stderr, "  -d    Convert compressed planar code to planar code.\n");
+    fprintf(stderr, "  -H    Do not write a header when converting to planar code.\n");
+    fprintf(stderr, "  -h    Print this help and return.\n");
+}
+
+int main(int argc, char *argv[]){
+    boolean decompress = FALSE;
+    boolean print_header = TRUE;
+    DEFAULT_PG_INPUT_OPTIONS(options);
+    int c;
+    
+    while((c = getopt(argc, argv, "dHh")) != -1){
+        switch(c){
+            case 'd':
+                decompress = TRUE;
+                break;
+            case 'H':
+                print_header = FALSE;
+                break;
+            case 'h':
+                help(argv[0]);
+                return EXIT_SUCCESS;
+            default:
+                help(argv[0]);
+                return EXIT_FAILURE;
+        }
+    }
+    
+    boolean success;
+    if(decompress){
+        success = decompress_planar_code(stdin, stdout, print_header);
+    } else {
+        success = compress_planar_code(stdin, stdout, &options);
+    }
+    
+    return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,53 @@
+/*
+ * Main developer: Nico Van Cleemput
+ * 
+ * Copyright (C) 2019 Nico Van Cleemput.
+ * Licensed under the GNU GPL, read the file LICENSE.txt for details.
+ */
+
+/* Removes isomorphic copies from a stream of plane graphs in planar code. The
+ * graphs are read from stdin, and the first graph of each isomorphism class
+ * is written to stdout.
+ */
+
+#include "planegraphs_base.h"
+#include "planegraphs_input.h"
+#include "planegraphs_dedup.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+static void help(char *name){
+    fprintf(stderr, "Usage: %s [options] < input > output\n\n", name);
+    fprintf(stderr, "Removes isomorphic copies (including mirror images) from the input.\n\n");
+    fprintf(stderr, "Valid options:\n");
+    fprintf(stderr, "  -H    Do not write a header to the output.\n");
+    fprintf(stderr, "  -h    Print this help and return.\n");
+}
+
+int main(int argc, char *argv[]){
+    boolean print_header = TRUE;
+    DEFAULT_PG_INPUT_OPTIONS(options);
+    unsigned long long read, written;
+    int c;
+    
+    while((c = getopt(argc, argv, "Hh")) != -1){
+        switch(c){
+            case 'H':
+                print_header = FALSE;
+                break;
+            case 'h':
+                help(argv[0]);
+                return EXIT_SUCCESS;
+            default:
+                help(argv[0]);
+                return EXIT_FAILURE;
+        }
+    }
+    
+    boolean success = remove_isomorphic_copies(stdin, stdout, &options, print_header, &read, &written);
+    
+    fprintf(stderr, "Read %llu graph%s, %llu non-isomorphic.\n", read, read == 1 ? "" : "s", written);
+    
+    return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
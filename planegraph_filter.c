@@ -0,0 +1,143 @@
+/*
+ * Main developer: Nico Van Cleemput
+ * 
+ * Copyright (C) 2019 Nico Van Cleemput.
+ * Licensed under the GNU GPL, read the file LICENSE.txt for details.
+ */
+
+/* Filters a stream of plane graphs in planar code. The graphs are read from
+ * stdin and the graphs that satisfy all given bounds are written to stdout,
+ * in the same order as they were read.
+ */
+
+#include "planegraphs_base.h"
+#include "planegraphs_input.h"
+#include "planegraphs_pipeline.h"
+#include "planegraphs_cycles.h"
+#include "planegraphs_connectivity.h"
+#include "planegraphs_automorphismgroup.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+typedef struct __filter_bounds {
+    int minimum_girth;
+    int minimum_edge_connectivity;
+    int minimum_connectivity;
+    int minimum_cyclic_edge_connectivity;
+    int minimum_degree;
+    int maximum_degree;
+    int minimum_group_order;
+} FILTER_BOUNDS;
+
+static boolean satisfies_bounds(PLANE_GRAPH *pg, void *data){
+    FILTER_BOUNDS *bounds = (FILTER_BOUNDS *)data;
+    
+    if(bounds->minimum_degree > 0 && minimum_degree(pg) < bounds->minimum_degree){
+        return FALSE;
+    }
+    if(bounds->maximum_degree > 0 && maximum_degree(pg) > bounds->maximum_degree){
+        return FALSE;
+    }
+    if(bounds->minimum_girth > 0 && !has_girth_at_least(pg, bounds->minimum_girth, NULL, NULL)){
+        return FALSE;
+    }
+    if(bounds->minimum_edge_connectivity > 0 && !is_k_edge_connected(pg, bounds->minimum_edge_connectivity, NULL, NULL)){
+        return FALSE;
+    }
+    if(bounds->minimum_connectivity > 0 && !is_k_connected(pg, bounds->minimum_connectivity, NULL, NULL)){
+        return FALSE;
+    }
+    if(bounds->minimum_cyclic_edge_connectivity > 0 && 
+            cyclic_edge_connectivity(pg, bounds->minimum_cyclic_edge_connectivity, NULL) < bounds->minimum_cyclic_edge_connectivity){
+        return FALSE;
+    }
+    if(bounds->minimum_group_order > 1 && 
+            count_automorphisms(pg, bounds->minimum_group_order, NULL, NULL, NULL) < bounds->minimum_group_order){
+        return FALSE;
+    }
+    
+    return TRUE;
+}
+
+static void help(char *name){
+    fprintf(stderr, "Usage: %s [options] < input > output\n\n", name);
+    fprintf(stderr, "Valid options:\n");
+    fprintf(stderr, "  -g n  Only keep graphs with girth at least n.\n");
+    fprintf(stderr, "  -c n  Only keep graphs with edge connectivity at least n.\n");
+    fprintf(stderr, "  -k n  Only keep graphs with vertex connectivity at least n.\n");
+    fprintf(stderr, "  -C n  Only keep cubic graphs with cyclic edge connectivity at least n.\n");
+    fprintf(stderr, "  -d n  Only keep graphs with minimum degree at least n.\n");
+    fprintf(stderr, "  -D n  Only keep graphs with maximum degree at most n.\n");
+    fprintf(stderr, "  -a n  Only keep graphs with at least n automorphisms.\n");
+    fprintf(stderr, "  -t n  Use n worker threads (default: 4).\n");
+    fprintf(stderr, "  -b n  Hand n graphs at once to a worker (default: 1024).\n");
+    fprintf(stderr, "  -H    Do not write a header to the output.\n");
+    fprintf(stderr, "  -h    Print this help and return.\n");
+}
+
+int main(int argc, char *argv[]){
+    FILTER_BOUNDS bounds = {0, 0, 0, 0, 0, 0, 0};
+    DEFAULT_PG_INPUT_OPTIONS(input_options);
+    DEFAULT_PG_PIPELINE_OPTIONS(options);
+    PG_PIPELINE_STATISTICS statistics;
+    int c;
+    
+    while((c = getopt(argc, argv, "g:c:k:C:d:D:a:t:b:Hh")) != -1){
+        switch(c){
+            case 'g':
+                bounds.minimum_girth = atoi(optarg);
+                break;
+            case 'c':
+                bounds.minimum_edge_connectivity = atoi(optarg);
+                break;
+            case 'k':
+                bounds.minimum_connectivity = atoi(optarg);
+                break;
+            case 'C':
+                bounds.minimum_cyclic_edge_connectivity = atoi(optarg);
+                break;
+            case 'd':
+                bounds.minimum_degree = atoi(optarg);
+                break;
+            case 'D':
+                bounds.maximum_degree = atoi(optarg);
+                break;
+            case 'a':
+                bounds.minimum_group_order = atoi(optarg);
+                break;
+            case 't':
+                options.thread_count = atoi(optarg);
+                break;
+            case 'b':
+                options.batch_size = atoi(optarg);
+                break;
+            case 'H':
+                options.print_header = FALSE;
+                break;
+            case 'h':
+                help(argv[0]);
+                return EXIT_SUCCESS;
+            default:
+                help(argv[0]);
+                return EXIT_FAILURE;
+        }
+    }
+    
+    //the connectivities are computed by walking the faces, and the automorphisms
+    //are determined using the faces
+    input_options.construct_faces = bounds.minimum_edge_connectivity > 0 || bounds.minimum_connectivity > 0 ||
+            bounds.minimum_cyclic_edge_connectivity > 0 || bounds.minimum_group_order > 1;
+    
+    boolean success = filter_planar_code(stdin, stdout, &input_options, satisfies_bounds, &bounds,
+                                         &options, &statistics);
+    
+    fprintf(stderr, "Read %llu graph%s, %llu accepted.\n", 
+            statistics.read, statistics.read == 1 ? "" : "s", statistics.accepted);
+    if(statistics.invalid){
+        fprintf(stderr, "%llu code%s could not be decoded.\n", 
+                statistics.invalid, statistics.invalid == 1 ? "" : "s");
+    }
+    
+    return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -8,14 +8,20 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include <limits.h>
+#include <string.h>
+#include <stdint.h>
+#include <pthread.h>
 
 #include "planegraphs_automorphismgroup.h"
 
 #define ABORT_IF_NULL(pointer) if(pointer==NULL){exit(-1);}
 
-//////////////////////////////////////////////////////////////////////////////
+//the flag of an edge: traversing the rotations in clockwise or in counterclockwise order
+#define FLAG(pg, e, reversed) (2*(int)((e) - (pg)->edges) + ((reversed) ? 1 : 0))
+#define FLAG_EDGE(pg, flag) ((pg)->edges + (flag)/2)
+#define FLAG_IS_REVERSED(flag) ((flag) & 1)
 
-typedef struct __pg_aut_comp_data PG_AUT_COMP_DATA;
+//////////////////////////////////////////////////////////////////////////////
 
 struct __pg_aut_comp_data {
     int *certificate;
@@ -29,57 +35,134 @@ struct __pg_aut_comp_data {
     PG_EDGE **orientation_reversing_starting_edges;
     int starting_edges_count; //the number of starting edges is always the same for both orientations
     
+    //colours used to narrow down the starting edges (see find_starting_edges)
+    uint64_t *vertex_colour;
+    uint64_t *new_vertex_colour;
+    uint64_t *face_colour;
+    uint64_t *new_face_colour;
+    uint64_t *corner_key;
+    //a hash table with the number of corners for each key
+    uint64_t *corner_key_table;
+    int *corner_key_frequency;
+    int corner_key_table_size; //always a power of 2
+    
     int *queue;
     
     boolean has_chiral_group;
+    
+    //the size of the graphs for which the arrays are large enough
+    int allocated_nv;
+    int allocated_ne;
+    int allocated_nf;
 };
 
-PG_AUT_COMP_DATA *get_automorphism_computation_workspace(PLANE_GRAPH *pg){
-    int e, n;
+PG_AUT_COMP_DATA *new_automorphism_computation_workspace(){
+    PG_AUT_COMP_DATA *workspace = calloc(1, sizeof(PG_AUT_COMP_DATA));
+    ABORT_IF_NULL(workspace);
+    
+    return workspace;
+}
+
+#define RESIZE_WORKSPACE_ARRAY(array, count) {\
+    (array) = realloc((array), sizeof(*(array)) * (count));\
+    ABORT_IF_NULL(array);\
+}
+
+/* Makes sure that the arrays in the workspace are large enough for the given
+ * graph. The arrays only grow, so a workspace can be reused for many graphs.
+ */
+void prepare_automorphism_computation_workspace(PG_AUT_COMP_DATA *workspace, PLANE_GRAPH *pg){
+    int e, n, f;
     
     e = pg->ne;
     n = pg->nv;
+    f = pg->nf + 1;
     
-    PG_AUT_COMP_DATA *workspace = malloc(sizeof(PG_AUT_COMP_DATA));
-    ABORT_IF_NULL(workspace);
+    //the certificate has to fit any graph with at most the allocated number of
+    //vertices and the allocated number of edges
+    if(n > workspace->allocated_nv || e > workspace->allocated_ne){
+        RESIZE_WORKSPACE_ARRAY(workspace->certificate, 
+                (e > workspace->allocated_ne ? e : workspace->allocated_ne) + 
+                (n > workspace->allocated_nv ? n : workspace->allocated_nv));
+    }
     
-    workspace->certificate = malloc(sizeof(int)*(e+n));
-    ABORT_IF_NULL(workspace->certificate);
-    workspace->canonical_labelling = malloc(sizeof(int) * n);
-    ABORT_IF_NULL(workspace->canonical_labelling);
-    workspace->reverse_canonical_labelling = malloc(sizeof(int) * n);
-    ABORT_IF_NULL(workspace->reverse_canonical_labelling);
-    workspace->canonical_first_edge = malloc(sizeof(PG_EDGE*) * n);
-    ABORT_IF_NULL(workspace->canonical_first_edge);
-    workspace->alternate_labelling = malloc(sizeof(int) * n);
-    ABORT_IF_NULL(workspace->alternate_labelling);
-    workspace->alternate_first_edge = malloc(sizeof(PG_EDGE*) * n);
-    ABORT_IF_NULL(workspace->alternate_first_edge);
-    
-    workspace->orientation_preserving_starting_edges = malloc(sizeof(PG_EDGE*) * e);
-    ABORT_IF_NULL(workspace->orientation_preserving_starting_edges);
-    workspace->orientation_reversing_starting_edges = malloc(sizeof(PG_EDGE*) * e);
-    ABORT_IF_NULL(workspace->orientation_reversing_starting_edges);
-    
-    workspace->queue = malloc(sizeof(int)*n);
-    ABORT_IF_NULL(workspace->queue);
+    if(n > workspace->allocated_nv){
+        RESIZE_WORKSPACE_ARRAY(workspace->canonical_labelling, n);
+        RESIZE_WORKSPACE_ARRAY(workspace->reverse_canonical_labelling, n);
+        RESIZE_WORKSPACE_ARRAY(workspace->canonical_first_edge, n);
+        RESIZE_WORKSPACE_ARRAY(workspace->alternate_labelling, n);
+        RESIZE_WORKSPACE_ARRAY(workspace->alternate_first_edge, n);
+        RESIZE_WORKSPACE_ARRAY(workspace->vertex_colour, n);
+        RESIZE_WORKSPACE_ARRAY(workspace->new_vertex_colour, n);
+        RESIZE_WORKSPACE_ARRAY(workspace->queue, n);
+        workspace->allocated_nv = n;
+    }
     
+    if(e > workspace->allocated_ne){
+        RESIZE_WORKSPACE_ARRAY(workspace->orientation_preserving_starting_edges, e);
+        RESIZE_WORKSPACE_ARRAY(workspace->orientation_reversing_starting_edges, e);
+        RESIZE_WORKSPACE_ARRAY(workspace->corner_key, e);
+        workspace->corner_key_table_size = 1;
+        while(workspace->corner_key_table_size < 2 * e){
+            workspace->corner_key_table_size *= 2;
+        }
+        RESIZE_WORKSPACE_ARRAY(workspace->corner_key_table, workspace->corner_key_table_size);
+        RESIZE_WORKSPACE_ARRAY(workspace->corner_key_frequency, workspace->corner_key_table_size);
+        workspace->allocated_ne = e;
+    }
+    
+    if(f > workspace->allocated_nf){
+        RESIZE_WORKSPACE_ARRAY(workspace->face_colour, f);
+        RESIZE_WORKSPACE_ARRAY(workspace->new_face_colour, f);
+        workspace->allocated_nf = f;
+    }
+}
+
+PG_AUT_COMP_DATA *get_automorphism_computation_workspace(PLANE_GRAPH *pg){
+    PG_AUT_COMP_DATA *workspace = new_automorphism_computation_workspace();
+    prepare_automorphism_computation_workspace(workspace, pg);
     return workspace;
 }
 
+void free_automorphism_computation_workspace(PG_AUT_COMP_DATA *workspace){
+    free(workspace->certificate);
+    free(workspace->canonical_labelling);
+    free(workspace->reverse_canonical_labelling);
+    free(workspace->canonical_first_edge);
+    free(workspace->alternate_labelling);
+    free(workspace->alternate_first_edge);
+    free(workspace->orientation_preserving_starting_edges);
+    free(workspace->orientation_reversing_starting_edges);
+    free(workspace->vertex_colour);
+    free(workspace->new_vertex_colour);
+    free(workspace->face_colour);
+    free(workspace->new_face_colour);
+    free(workspace->corner_key);
+    free(workspace->corner_key_table);
+    free(workspace->corner_key_frequency);
+    free(workspace->queue);
+    free(workspace);
+}
+
+//the number of automorphisms for which space is reserved initially
+#define INITIAL_AUTOMORPHISM_CAPACITY 8
+
 PG_AUTOMORPHISM_GROUP *allocate_automorphism_group(PLANE_GRAPH *pg){
-    int i;
-    
     PG_AUTOMORPHISM_GROUP *aut = (PG_AUTOMORPHISM_GROUP *)malloc(sizeof(PG_AUTOMORPHISM_GROUP));
+    ABORT_IF_NULL(aut);
     
-    aut->automorphisms = (int **)malloc(sizeof(int *)*(pg->ne)*2);
+    aut->graph = pg;
     
-    for(i = 0; i < (pg->ne)*2; i++){
-        aut->automorphisms[i] = (int *)malloc(sizeof(int)*(pg->nv));
-    }
+    aut->automorphisms = NULL;
+    aut->storage = NULL;
+    aut->allocated_size = 0;
     
-    aut->allocated_size = (pg->ne) * 2;
-    aut->graph = pg;
+    aut->generators = NULL;
+    aut->generator_storage = NULL;
+    aut->generator_count = 0;
+    aut->allocated_generator_count = 0;
+    aut->elements = NULL;
+    aut->starting_edge = 0;
     
     aut->size = 0;
     aut->orientation_preserving_count = 0;
@@ -88,88 +171,206 @@ PG_AUTOMORPHISM_GROUP *allocate_automorphism_group(PLANE_GRAPH *pg){
     return aut;
 }
 
-void trim_automorphism_group(PG_AUTOMORPHISM_GROUP *aut){
-    int i;
+/* Makes sure that there is room for at least one more automorphism. All
+ * automorphisms are stored in one contiguous buffer which grows when needed.
+ */
+void ensure_automorphism_capacity(PG_AUTOMORPHISM_GROUP *aut){
+    int i, nv = aut->graph->nv;
     
-    for(i = aut->size; i < aut->allocated_size; i++){
-        free(aut->automorphisms[i]);
+    if(aut->size < aut->allocated_size){
+        return;
     }
     
-    aut->automorphisms = (int **)realloc(aut->automorphisms, sizeof(int *)*(aut->size));
-    aut->allocated_size = aut->size;
+    int new_size = aut->allocated_size ? 2 * aut->allocated_size : INITIAL_AUTOMORPHISM_CAPACITY;
+    aut->storage = (int *)realloc(aut->storage, sizeof(int) * nv * new_size);
+    ABORT_IF_NULL(aut->storage);
+    aut->automorphisms = (int **)realloc(aut->automorphisms, sizeof(int *) * new_size);
+    ABORT_IF_NULL(aut->automorphisms);
+    aut->elements = (int *)realloc(aut->elements, sizeof(int) * new_size);
+    ABORT_IF_NULL(aut->elements);
+    
+    for(i = 0; i < new_size; i++){
+        aut->automorphisms[i] = aut->storage + i * nv;
+    }
+    aut->allocated_size = new_size;
 }
 
-void free_automorphism_group(PG_AUTOMORPHISM_GROUP *aut){
-    int i;
+void trim_automorphism_group(PG_AUTOMORPHISM_GROUP *aut){
+    int i, nv = aut->graph->nv;
     
-    for(i = 0; i < aut->allocated_size; i++){
-        free(aut->automorphisms[i]);
+    if(aut->automorphisms == NULL || aut->size == aut->allocated_size){
+        return;
     }
     
+    int *new_storage = (int *)realloc(aut->storage, sizeof(int) * nv * aut->size);
+    if(new_storage == NULL){
+        //keep the larger buffer
+        return;
+    }
+    aut->storage = new_storage;
+    for(i = 0; i < aut->size; i++){
+        aut->automorphisms[i] = aut->storage + i * nv;
+    }
+    aut->allocated_size = aut->size;
+}
+
+void free_automorphism_group(PG_AUTOMORPHISM_GROUP *aut){
     free(aut->automorphisms);
+    free(aut->generators);
+    free(aut->generator_storage);
+    free(aut->storage);
+    free(aut->elements);
     free(aut);
 }
 
-void find_starting_edges(PLANE_GRAPH *pg, PG_AUT_COMP_DATA *workspace){
-    int i, starting_degree, starting_face_size, minimum_frequency;
-    int vertex_degree_frequency[pg->nv];
-    int face_size_frequency[pg->nv];
-    PG_EDGE *start, *edge;
+//the maximum number of refinement rounds in find_starting_edges
+#define MAXIMUM_REFINEMENT_ROUNDS 32
+//the refinement stops when the number of starting edges did not decrease during this number of rounds
+#define MAXIMUM_STALLED_ROUNDS 2
+
+/* A bijective mixing function for 64-bit integers (the finaliser of splitmix64).
+ */
+static uint64_t mix_colour(uint64_t x){
+    x ^= x >> 30;
+    x *= 0xbf58476d1ce4e5b9ULL;
+    x ^= x >> 27;
+    x *= 0x94d049bb133111ebULL;
+    x ^= x >> 31;
+    return x;
+}
+
+/* Computes a key for each corner (e, e->next) of the graph based on the
+ * current colours of the vertices and faces. The key does not depend on the 
+ * order of the two neighbours, so a corner and its mirror image get the same
+ * key. The corner keys are counted and the smallest key of the smallest class
+ * is returned. The number of corners with that key is stored in count.
+ */
+static uint64_t determine_starting_corner_key(PLANE_GRAPH *pg, PG_AUT_COMP_DATA *workspace, int *count){
+    int i, slot, best_count;
+    int mask = workspace->corner_key_table_size - 1;
+    uint64_t key, best_key, left, right;
+    PG_EDGE *e;
     
-    for(i = 0; i < pg->nv; i++){
-        vertex_degree_frequency[i] = face_size_frequency[i] = 0;
+    memset(workspace->corner_key_frequency, 0, sizeof(int) * workspace->corner_key_table_size);
+    
+    for(i = 0; i < pg->ne; i++){
+        e = pg->edges + i;
+        left = workspace->vertex_colour[e->end];
+        right = workspace->vertex_colour[e->next->end];
+        if(left > right){
+            uint64_t temp = left;
+            left = right;
+            right = temp;
+        }
+        key = mix_colour(mix_colour(mix_colour(workspace->vertex_colour[e->start]) 
+                                    + workspace->face_colour[e->right_face]) + left) + right;
+        workspace->corner_key[i] = key;
+        
+        slot = (int)(key & mask);
+        while(workspace->corner_key_frequency[slot] && workspace->corner_key_table[slot] != key){
+            slot = (slot + 1) & mask;
+        }
+        workspace->corner_key_table[slot] = key;
+        workspace->corner_key_frequency[slot]++;
     }
     
-    workspace->starting_edges_count = 0;
+    best_key = 0;
+    best_count = pg->ne + 1;
+    for(i = 0; i <= mask; i++){
+        if(workspace->corner_key_frequency[i] && 
+                (workspace->corner_key_frequency[i] < best_count ||
+                (workspace->corner_key_frequency[i] == best_count && workspace->corner_key_table[i] < best_key))){
+            best_count = workspace->corner_key_frequency[i];
+            best_key = workspace->corner_key_table[i];
+        }
+    }
+    
+    *count = best_count;
+    return best_key;
+}
+
+/* Refines the colours of the vertices and faces: the new colour of a vertex
+ * depends on its old colour and on the colours of its neighbours and its 
+ * incident faces, and similarly for a face. The neighbourhoods are combined
+ * with a sum, so the colours are invariant under reflections.
+ */
+static void refine_colours(PLANE_GRAPH *pg, PG_AUT_COMP_DATA *workspace){
+    int i;
+    uint64_t colour, *temp;
+    PG_EDGE *e, *elast;
     
-    //build the degree frequency table
     for(i = 0; i < pg->nv; i++){
-        vertex_degree_frequency[pg->degree[i]]++;
+        colour = mix_colour(workspace->vertex_colour[i]);
+        e = elast = pg->first_edge[i];
+        do {
+            colour += mix_colour(workspace->vertex_colour[e->end] + 1)
+                    + mix_colour(workspace->face_colour[e->right_face] + 2);
+            e = e->next;
+        } while (e != elast);
+        workspace->new_vertex_colour[i] = colour;
     }
     
-    //find the smallest degree with the lowest frequency
-    minimum_frequency = pg->nv + 1;
-    for(i = 0; i < pg->nv; i++){
-        if(vertex_degree_frequency[i] && vertex_degree_frequency[i] < minimum_frequency){
-            starting_degree = i;
-            minimum_frequency = vertex_degree_frequency[i];
-        }
+    for(i = 0; i < pg->nf; i++){
+        colour = mix_colour(workspace->face_colour[i] + 3);
+        e = elast = pg->face_start[i];
+        do {
+            colour += mix_colour(workspace->vertex_colour[e->start] + 4)
+                    + mix_colour(workspace->face_colour[e->inverse->right_face] + 5);
+            e = e->inverse->prev;
+        } while (e != elast);
+        workspace->new_face_colour[i] = colour;
     }
     
-    //build the frequency table of face sizes incident to a vertex with starting_degree
+    temp = workspace->vertex_colour;
+    workspace->vertex_colour = workspace->new_vertex_colour;
+    workspace->new_vertex_colour = temp;
+    temp = workspace->face_colour;
+    workspace->face_colour = workspace->new_face_colour;
+    workspace->new_face_colour = temp;
+}
+
+/* Determines the edges from which a certificate is constructed. Each 
+ * automorphism maps the starting edges to starting edges, so it is sufficient
+ * that the set of starting edges is defined in an isomorphism invariant way.
+ * The vertices and faces are coloured by their degree and size, and these 
+ * colours are iteratively refined. After each round the corners are classified
+ * by the colours around them, and the smallest class is used. The refinement
+ * stops as soon as the class no longer gets smaller.
+ */
+void find_starting_edges(PLANE_GRAPH *pg, PG_AUT_COMP_DATA *workspace){
+    int i, round, count, previous_count, stalled_rounds;
+    uint64_t starting_key;
+    PG_EDGE *edge;
+    
     for(i = 0; i < pg->nv; i++){
-        if(pg->degree[i] == starting_degree){
-            start = edge = pg->first_edge[i];
-            
-            do {
-                face_size_frequency[pg->face_size[edge->right_face]]++;
-                edge = edge->next;
-            } while (start != edge);
-        }
+        workspace->vertex_colour[i] = mix_colour(pg->degree[i]);
+    }
+    for(i = 0; i < pg->nf; i++){
+        workspace->face_colour[i] = mix_colour(pg->face_size[i] + 6);
     }
     
-    //find the smallest face size incident with a vertex of starting_degree and with smallest frequency
-    minimum_frequency = pg->ne + 1;
-    for(i = 0; i < pg->nv; i++){
-        if(face_size_frequency[i] && face_size_frequency[i] < minimum_frequency){
-            starting_face_size = i;
-            minimum_frequency = face_size_frequency[i];
+    starting_key = determine_starting_corner_key(pg, workspace, &count);
+    previous_count = count;
+    stalled_rounds = 0;
+    for(round = 0; round < MAXIMUM_REFINEMENT_ROUNDS && count > 1 && stalled_rounds < MAXIMUM_STALLED_ROUNDS; round++){
+        refine_colours(pg, workspace);
+        starting_key = determine_starting_corner_key(pg, workspace, &count);
+        if(count < previous_count){
+            stalled_rounds = 0;
+            previous_count = count;
+        } else {
+            stalled_rounds++;
         }
     }
     
     //store all starting edges
-    for(i = 0; i < pg->nv; i++){
-        if(pg->degree[i] == starting_degree){
-            start = edge = pg->first_edge[i];
-            
-            do {
-                if(pg->face_size[edge->right_face] == starting_face_size){
-                    workspace->orientation_preserving_starting_edges[workspace->starting_edges_count] = edge;
-                    workspace->orientation_reversing_starting_edges[workspace->starting_edges_count] = edge->next;
-                    workspace->starting_edges_count++;
-                }
-                edge = edge->next;
-            } while (start != edge);
+    workspace->starting_edges_count = 0;
+    for(i = 0; i < pg->ne; i++){
+        if(workspace->corner_key[i] == starting_key){
+            edge = pg->edges + i;
+            workspace->orientation_preserving_starting_edges[workspace->starting_edges_count] = edge;
+            workspace->orientation_reversing_starting_edges[workspace->starting_edges_count] = edge->next;
+            workspace->starting_edges_count++;
         }
     }
 }
@@ -244,6 +445,7 @@ void construct_certificate_orientation_reversed(PLANE_GRAPH *pg, PG_EDGE *e_star
  */
 int has_better_certificate_orientation_preserving(PLANE_GRAPH *pg, PG_EDGE *e_start, PG_AUTOMORPHISM_GROUP *aut_group, PG_AUT_COMP_DATA *workspace){
     int i, j;
+    PG_STATS_ADD(PG_STATS_STARTING_EDGES_TRIED, 1);
     for(i=0; i<pg->nv; i++){
         workspace->alternate_labelling[i] = INT_MAX;
     }
@@ -266,10 +468,15 @@ int has_better_certificate_orientation_preserving(PLANE_GRAPH *pg, PG_EDGE *e_st
             }
             if(workspace->alternate_labelling[e->end] < workspace->certificate[current_pos]){
                 construct_certificate(pg, e_start, workspace);
-                aut_group->size = 1;
-                aut_group->orientation_preserving_count = 1;
+                if(aut_group != NULL){
+                    aut_group->size = 1;
+                    aut_group->orientation_preserving_count = 1;
+                    aut_group->starting_edge = aut_group->elements[0] = FLAG(pg, e_start, FALSE);
+                }
+                PG_STATS_ADD(PG_STATS_CERTIFICATE_EARLY_EXITS, 1);
                 return 1;
             } else if(workspace->alternate_labelling[e->end] > workspace->certificate[current_pos]){
+                PG_STATS_ADD(PG_STATS_CERTIFICATE_EARLY_EXITS, 1);
                 return -1;
             }
             current_pos++;
@@ -277,14 +484,20 @@ int has_better_certificate_orientation_preserving(PLANE_GRAPH *pg, PG_EDGE *e_st
         } while (e!=elast);
         //INT_MAX will always be at least the value of certificate[current_pos]
         if(INT_MAX > workspace->certificate[current_pos]){
+            PG_STATS_ADD(PG_STATS_CERTIFICATE_EARLY_EXITS, 1);
             return -1;
         }
         current_pos++;
     }
+    if(aut_group == NULL){
+        return 0;
+    }
+    ensure_automorphism_capacity(aut_group);
     for(j = 0; j < pg->nv; j++){
         aut_group->automorphisms[aut_group->size][j]
                 = workspace->reverse_canonical_labelling[workspace->alternate_labelling[j]];
     }
+    aut_group->elements[aut_group->size] = FLAG(pg, e_start, FALSE);
     aut_group->size++;
     aut_group->orientation_preserving_count++;
     return 0;
@@ -292,6 +505,7 @@ int has_better_certificate_orientation_preserving(PLANE_GRAPH *pg, PG_EDGE *e_st
 
 int has_better_certificate_orientation_reversing(PLANE_GRAPH *pg, PG_EDGE *e_start, PG_AUTOMORPHISM_GROUP *aut_group, PG_AUT_COMP_DATA *workspace){
     int i, j;
+    PG_STATS_ADD(PG_STATS_STARTING_EDGES_TRIED, 1);
     for(i=0; i<pg->nv; i++){
         workspace->alternate_labelling[i] = INT_MAX;
     }
@@ -315,11 +529,16 @@ int has_better_certificate_orientation_reversing(PLANE_GRAPH *pg, PG_EDGE *e_sta
             if(workspace->alternate_labelling[e->end] < workspace->certificate[current_pos]){
                 construct_certificate_orientation_reversed(pg, e_start, workspace);
                 workspace->has_chiral_group = TRUE;
-                aut_group->size = 1;
-                aut_group->orientation_preserving_count = 1;
-                aut_group->orientation_reversing_count = 0;
+                if(aut_group != NULL){
+                    aut_group->size = 1;
+                    aut_group->orientation_preserving_count = 1;
+                    aut_group->orientation_reversing_count = 0;
+                    aut_group->starting_edge = aut_group->elements[0] = FLAG(pg, e_start, TRUE);
+                }
+                PG_STATS_ADD(PG_STATS_CERTIFICATE_EARLY_EXITS, 1);
                 return 1;
             } else if(workspace->alternate_labelling[e->end] > workspace->certificate[current_pos]){
+                PG_STATS_ADD(PG_STATS_CERTIFICATE_EARLY_EXITS, 1);
                 return -1;
             }
             current_pos++;
@@ -327,14 +546,20 @@ int has_better_certificate_orientation_reversing(PLANE_GRAPH *pg, PG_EDGE *e_sta
         } while (e!=elast);
         //INT_MAX will always be at least the value of certificate[current_pos]
         if(INT_MAX > workspace->certificate[current_pos]){
+            PG_STATS_ADD(PG_STATS_CERTIFICATE_EARLY_EXITS, 1);
             return -1;
         }
         current_pos++;
     }
+    if(aut_group == NULL){
+        return 0;
+    }
+    ensure_automorphism_capacity(aut_group);
     for(j = 0; j < pg->nv; j++){
         aut_group->automorphisms[aut_group->size][j]
                 = workspace->reverse_canonical_labelling[workspace->alternate_labelling[j]];
     }
+    aut_group->elements[aut_group->size] = FLAG(pg, e_start, TRUE);
     if(workspace->has_chiral_group){
         aut_group->orientation_preserving_count++;
     } else {
@@ -344,10 +569,45 @@ int has_better_certificate_orientation_reversing(PLANE_GRAPH *pg, PG_EDGE *e_sta
     return 0;
 }
 
+/* Determines the minimal certificate over all starting edges in both
+ * orientations. If aut is not NULL, then the automorphisms are stored in aut.
+ */
+void determine_minimal_certificate(PLANE_GRAPH *pg, PG_AUTOMORPHISM_GROUP *aut, PG_AUT_COMP_DATA *workspace){
+    int i;
+    PG_STATS_START(PG_STATS_PHASE_AUTOMORPHISMS);
+    
+    workspace->has_chiral_group = FALSE;
+    
+    //find starting edges
+    find_starting_edges(pg, workspace);
+    
+    //construct initial certificate
+    construct_certificate(pg, workspace->orientation_preserving_starting_edges[0], workspace);
+    if(aut != NULL){
+        aut->starting_edge = aut->elements[0] = FLAG(pg, workspace->orientation_preserving_starting_edges[0], FALSE);
+    }
+    
+    //look for better automorphism
+    for(i = 1; i < workspace->starting_edges_count; i++){
+        has_better_certificate_orientation_preserving(pg, workspace->orientation_preserving_starting_edges[i],
+                                                      aut, workspace);
+        //if result == 1, then the counts are already reset and the new certificate is stored
+        //if result == 0, then the automorphism is already stored
+    }
+    for(i = 0; i < workspace->starting_edges_count; i++){
+        has_better_certificate_orientation_reversing(pg, workspace->orientation_reversing_starting_edges[i],
+                                                     aut, workspace);
+        //if result == 1, then the counts are already reset and the new certificate is stored
+        //if result == 0, then the automorphism is already stored
+    }
+    PG_STATS_STOP(PG_STATS_PHASE_AUTOMORPHISMS);
+}
+
 PG_AUTOMORPHISM_GROUP *determine_automorphisms(PLANE_GRAPH *pg){
     int i;
     
     PG_AUTOMORPHISM_GROUP *aut = allocate_automorphism_group(pg);
+    ensure_automorphism_capacity(aut);
     
     //identity
     for(i = 0; i < pg->nv; i++){
@@ -358,30 +618,770 @@ PG_AUTOMORPHISM_GROUP *determine_automorphisms(PLANE_GRAPH *pg){
     aut->orientation_preserving_count = 1;
     aut->orientation_reversing_count = 0;
     
+    PG_AUT_COMP_DATA *workspace = get_automorphism_computation_workspace(pg);
+    
+    determine_minimal_certificate(pg, aut, workspace);
+    
+    free_automorphism_computation_workspace(workspace);
+    
+    trim_automorphism_group(aut);
+    
+    return aut;
+}
+
+//the number of consecutive starting edges that a worker takes at once
+#define PARALLEL_CANDIDATE_CHUNK 16
+
+typedef struct __pg_aut_parallel_data PG_AUT_PARALLEL_DATA;
+typedef struct __pg_aut_worker PG_AUT_WORKER;
+
+/* The data shared by the workers of determine_automorphisms_parallel. The 
+ * candidates are the orientation preserving starting edges followed by the
+ * orientation reversing starting edges.
+ */
+struct __pg_aut_parallel_data {
+    PLANE_GRAPH *pg;
+    PG_AUT_COMP_DATA *workspace;
+    int candidate_count;
+    
+    //the next candidate that has not been handed to a worker
+    int next_candidate;
+    pthread_mutex_t lock;
+};
+
+struct __pg_aut_worker {
+    pthread_t thread;
+    PG_AUT_PARALLEL_DATA *data;
+    PG_AUT_COMP_DATA *workspace;
+    
+    //the first candidate with the smallest certificate seen by this worker
+    int best_candidate;
+    
+    //the later candidates that give the same certificate as best_candidate, 
+    //and the automorphisms that map them to best_candidate
+    int *candidates;
+    int *images;
+    int count;
+    int allocated_count;
+};
+
+PG_EDGE *get_candidate(PG_AUT_COMP_DATA *workspace, int candidate, boolean *reversed){
+    *reversed = candidate >= workspace->starting_edges_count;
+    if(*reversed){
+        return workspace->orientation_reversing_starting_edges[candidate - workspace->starting_edges_count];
+    } else {
+        return workspace->orientation_preserving_starting_edges[candidate];
+    }
+}
+
+/* Stores the next chunk of candidates for a worker in [*first, *last). Chunks
+ * are handed out in increasing order.
+ */
+boolean get_candidate_chunk(PG_AUT_PARALLEL_DATA *data, int *first, int *last){
+    pthread_mutex_lock(&(data->lock));
+    *first = data->next_candidate;
+    *last = *first + PARALLEL_CANDIDATE_CHUNK;
+    if(*last > data->candidate_count){
+        *last = data->candidate_count;
+    }
+    data->next_candidate = *last;
+    pthread_mutex_unlock(&(data->lock));
+    return *first < *last;
+}
+
+/* Determines the smallest certificate of the candidates handled by this worker,
+ * and the automorphisms that map the other candidates with that certificate to
+ * the first one.
+ */
+void *find_automorphisms_worker(void *argument){
+    PG_AUT_WORKER *worker = (PG_AUT_WORKER *)argument;
+    PG_AUT_PARALLEL_DATA *data = worker->data;
+    PLANE_GRAPH *pg = data->pg;
+    int i, j, result, first, last;
+    boolean reversed;
+    
+    worker->best_candidate = -1;
+    worker->count = 0;
+    while(get_candidate_chunk(data, &first, &last)){
+        for(i = first; i < last; i++){
+            PG_EDGE *e = get_candidate(data->workspace, i, &reversed);
+            if(worker->best_candidate == -1){
+                if(reversed){
+                    construct_certificate_orientation_reversed(pg, e, worker->workspace);
+                } else {
+                    construct_certificate(pg, e, worker->workspace);
+                }
+                worker->best_candidate = i;
+                continue;
+            }
+            
+            if(reversed){
+                result = has_better_certificate_orientation_reversing(pg, e, NULL, worker->workspace);
+            } else {
+                result = has_better_certificate_orientation_preserving(pg, e, NULL, worker->workspace);
+            }
+            if(result == 1){
+                worker->best_candidate = i;
+                worker->count = 0;
+            }
+            if(result != 0) continue;
+            
+            if(worker->count == worker->allocated_count){
+                worker->allocated_count = worker->allocated_count ? 2 * worker->allocated_count : 
+                                                                    INITIAL_AUTOMORPHISM_CAPACITY;
+                worker->candidates = (int *)realloc(worker->candidates, sizeof(int) * worker->allocated_count);
+                ABORT_IF_NULL(worker->candidates);
+                worker->images = (int *)realloc(worker->images, sizeof(int) * pg->nv * worker->allocated_count);
+                ABORT_IF_NULL(worker->images);
+            }
+            int *image = worker->images + worker->count * pg->nv;
+            for(j = 0; j < pg->nv; j++){
+                image[j] = worker->workspace->reverse_canonical_labelling[worker->workspace->alternate_labelling[j]];
+            }
+            worker->candidates[worker->count++] = i;
+        }
+    }
+    
+    return NULL;
+}
+
+/* Returns a negative number if the certificate of the first workspace is 
+ * smaller than that of the second, 0 if they are equal, and a positive number
+ * otherwise.
+ */
+int compare_certificates(PLANE_GRAPH *pg, PG_AUT_COMP_DATA *workspace1, PG_AUT_COMP_DATA *workspace2){
+    int i;
+    for(i = 0; i < pg->ne + pg->nv; i++){
+        if(workspace1->certificate[i] != workspace2->certificate[i]){
+            return workspace1->certificate[i] < workspace2->certificate[i] ? -1 : 1;
+        }
+    }
+    return 0;
+}
+
+PG_AUTOMORPHISM_GROUP *determine_automorphisms_parallel(PLANE_GRAPH *pg, int thread_count){
+    int i, j, best_worker;
+    boolean reversed, starting_reversed;
+    
+    if(thread_count <= 1){
+        return determine_automorphisms(pg);
+    }
+    PG_STATS_START(PG_STATS_PHASE_AUTOMORPHISMS);
+    
+    PG_AUT_PARALLEL_DATA data;
+    data.pg = pg;
+    data.workspace = get_automorphism_computation_workspace(pg);
+    find_starting_edges(pg, data.workspace);
+    data.candidate_count = 2 * data.workspace->starting_edges_count;
+    data.next_candidate = 0;
+    pthread_mutex_init(&(data.lock), NULL);
+    
+    PG_AUT_WORKER *workers = (PG_AUT_WORKER *)calloc(thread_count, sizeof(PG_AUT_WORKER));
+    ABORT_IF_NULL(workers);
+    for(i = 0; i < thread_count; i++){
+        workers[i].data = &data;
+        workers[i].workspace = get_automorphism_computation_workspace(pg);
+    }
+    
+    for(i = 1; i < thread_count; i++){
+        if(pthread_create(&(workers[i].thread), NULL, find_automorphisms_worker, workers + i)){
+            fprintf(stderr, "Could not create thread.\n");
+            exit(-1);
+        }
+    }
+    //the calling thread is the first worker
+    find_automorphisms_worker(workers);
+    for(i = 1; i < thread_count; i++){
+        pthread_join(workers[i].thread, NULL);
+    }
+    
+    //among equal certificates the first candidate is used, just as in
+    //determine_automorphisms
+    best_worker = -1;
+    for(i = 0; i < thread_count; i++){
+        if(workers[i].best_candidate == -1) continue;
+        if(best_worker == -1){
+            best_worker = i;
+            continue;
+        }
+        int comparison = compare_certificates(pg, workers[i].workspace, workers[best_worker].workspace);
+        if(comparison < 0 || (comparison == 0 && workers[i].best_candidate < workers[best_worker].best_candidate)){
+            best_worker = i;
+        }
+    }
+    int starting_candidate = workers[best_worker].best_candidate;
+    int *reverse_canonical_labelling = workers[best_worker].workspace->reverse_canonical_labelling;
+    
+    //the automorphisms found by a worker with the minimal certificate map to 
+    //the best candidate of that worker: relabel them such that they map to the
+    //starting candidate
+    int *found = (int *)malloc(sizeof(int) * (data.candidate_count + 1));
+    int *found_images = (int *)malloc(sizeof(int) * (data.candidate_count + 1));
+    ABORT_IF_NULL(found);
+    ABORT_IF_NULL(found_images);
+    for(i = 0; i < data.candidate_count; i++){
+        found[i] = -1;
+    }
+    for(i = 0; i < thread_count; i++){
+        PG_AUT_WORKER *worker = workers + i;
+        if(worker->best_candidate == -1 || 
+                (i != best_worker && compare_certificates(pg, worker->workspace, workers[best_worker].workspace))){
+            continue;
+        }
+        int *canonical_labelling = worker->workspace->canonical_labelling;
+        for(j = 0; j < worker->count; j++){
+            int *image = worker->images + j * pg->nv;
+            for(int v = 0; v < pg->nv; v++){
+                image[v] = reverse_canonical_labelling[canonical_labelling[image[v]]];
+            }
+            found[worker->candidates[j]] = i;
+            found_images[worker->candidates[j]] = j;
+        }
+        if(i != best_worker){
+            found[worker->best_candidate] = i;
+            found_images[worker->best_candidate] = -1;
+        }
+    }
+    
+    PG_AUTOMORPHISM_GROUP *aut = allocate_automorphism_group(pg);
+    ensure_automorphism_capacity(aut);
+    for(i = 0; i < pg->nv; i++){
+        aut->automorphisms[0][i] = i;
+    }
+    PG_EDGE *starting_edge = get_candidate(data.workspace, starting_candidate, &starting_reversed);
+    aut->starting_edge = aut->elements[0] = FLAG(pg, starting_edge, starting_reversed);
+    aut->size = 1;
+    aut->orientation_preserving_count = 1;
+    aut->orientation_reversing_count = 0;
+    for(i = starting_candidate + 1; i < data.candidate_count; i++){
+        if(found[i] == -1) continue;
+        PG_AUT_WORKER *worker = workers + found[i];
+        PG_EDGE *e = get_candidate(data.workspace, i, &reversed);
+        ensure_automorphism_capacity(aut);
+        if(found_images[i] == -1){
+            //the best candidate of another worker
+            for(j = 0; j < pg->nv; j++){
+                aut->automorphisms[aut->size][j] = reverse_canonical_labelling[worker->workspace->canonical_labelling[j]];
+            }
+        } else {
+            memcpy(aut->automorphisms[aut->size], worker->images + found_images[i] * pg->nv, sizeof(int) * pg->nv);
+        }
+        aut->elements[aut->size] = FLAG(pg, e, reversed);
+        if(reversed == starting_reversed){
+            aut->orientation_preserving_count++;
+        } else {
+            aut->orientation_reversing_count++;
+        }
+        aut->size++;
+    }
+    trim_automorphism_group(aut);
+    
+    free(found);
+    free(found_images);
+    for(i = 0; i < thread_count; i++){
+        free(workers[i].candidates);
+        free(workers[i].images);
+        free_automorphism_computation_workspace(workers[i].workspace);
+    }
+    free(workers);
+    pthread_mutex_destroy(&(data.lock));
+    free_automorphism_computation_workspace(data.workspace);
+    PG_STATS_STOP(PG_STATS_PHASE_AUTOMORPHISMS);
+    
+    return aut;
+}
+
+int count_automorphisms(PLANE_GRAPH *pg, int threshold, int *orientation_preserving_count,
+                        int *orientation_reversing_count, PG_AUT_COMP_DATA *workspace){
+    int i, result, size, preserving_count, reversing_count;
+    boolean own_workspace = workspace == NULL;
+    PG_STATS_START(PG_STATS_PHASE_AUTOMORPHISMS);
+    
+    if(own_workspace){
+        workspace = new_automorphism_computation_workspace();
+    }
+    prepare_automorphism_computation_workspace(workspace, pg);
+    workspace->has_chiral_group = FALSE;
+    
+    find_starting_edges(pg, workspace);
+    construct_certificate(pg, workspace->orientation_preserving_starting_edges[0], workspace);
+    size = preserving_count = 1;
+    reversing_count = 0;
+    
+    //each starting edge that gives the current certificate corresponds to a
+    //different automorphism, so size is always a lower bound for the group order
+    for(i = 1; i < workspace->starting_edges_count && (threshold <= 0 || size < threshold); i++){
+        result = has_better_certificate_orientation_preserving(pg, workspace->orientation_preserving_starting_edges[i],
+                                                               NULL, workspace);
+        if(result == 1){
+            size = preserving_count = 1;
+        } else if(result == 0){
+            size++;
+            preserving_count++;
+        }
+    }
+    for(i = 0; i < workspace->starting_edges_count && (threshold <= 0 || size < threshold); i++){
+        result = has_better_certificate_orientation_reversing(pg, workspace->orientation_reversing_starting_edges[i],
+                                                              NULL, workspace);
+        if(result == 1){
+            size = preserving_count = 1;
+            reversing_count = 0;
+        } else if(result == 0){
+            size++;
+            if(workspace->has_chiral_group){
+                preserving_count++;
+            } else {
+                reversing_count++;
+            }
+        }
+    }
+    
+    if(orientation_preserving_count != NULL){
+        *orientation_preserving_count = preserving_count;
+    }
+    if(orientation_reversing_count != NULL){
+        *orientation_reversing_count = reversing_count;
+    }
+    
+    if(own_workspace){
+        free_automorphism_computation_workspace(workspace);
+    }
+    PG_STATS_STOP(PG_STATS_PHASE_AUTOMORPHISMS);
+    
+    return size;
+}
+
+/* Stores in image the images of the vertices under the automorphism that maps
+ * the flag start to the flag target. If edge_image is not NULL, then the images
+ * of the edges (as indices in pg->edges) are stored in it as well. The arrays
+ * first, first_image and queue should have room for nv elements.
+ */
+void expand_flag_map(PLANE_GRAPH *pg, int start, int target, int *image, int *edge_image,
+                     PG_EDGE **first, PG_EDGE **first_image, int *queue){
+    int i;
+    PG_EDGE *e, *e_image;
+    boolean reversed = FLAG_IS_REVERSED(start);
+    boolean image_reversed = FLAG_IS_REVERSED(target);
+    
+    for(i = 0; i < pg->nv; i++){
+        image[i] = -1;
+    }
+    
+    e = FLAG_EDGE(pg, start);
+    e_image = FLAG_EDGE(pg, target);
+    int head = 1;
+    int tail = 0;
+    queue[0] = e->start;
+    first[e->start] = e;
+    first_image[e->start] = e_image;
+    image[e->start] = e_image->start;
+    while(head > tail){
+        int current_vertex = queue[tail++];
+        e = first[current_vertex];
+        e_image = first_image[current_vertex];
+        do {
+            if(image[e->end] == -1){
+                queue[head++] = e->end;
+                image[e->end] = e_image->end;
+                first[e->end] = e->inverse;
+                first_image[e->end] = e_image->inverse;
+            }
+            if(edge_image != NULL){
+                edge_image[e - pg->edges] = e_image - pg->edges;
+            }
+            e = reversed ? e->prev : e->next;
+            e_image = image_reversed ? e_image->prev : e_image->next;
+        } while (e != first[current_vertex]);
+    }
+}
+
+/* Adds the automorphism that maps the starting edge to the given flag to the
+ * generators. All generators are stored in one contiguous buffer: each
+ * generator consists of the images of the vertices, the images of the edges
+ * and 1 if the generator reverses the orientation (0 otherwise).
+ */
+void add_generator(PG_AUTOMORPHISM_GROUP *aut, int flag, PG_AUT_COMP_DATA *workspace){
+    int i;
+    PLANE_GRAPH *pg = aut->graph;
+    int stride = pg->nv + pg->ne + 1;
+    
+    if(aut->generator_count == aut->allocated_generator_count){
+        int new_size = aut->allocated_generator_count ? 2 * aut->allocated_generator_count : 4;
+        aut->generator_storage = (int *)realloc(aut->generator_storage, sizeof(int) * stride * new_size);
+        ABORT_IF_NULL(aut->generator_storage);
+        aut->generators = (int **)realloc(aut->generators, sizeof(int *) * new_size);
+        ABORT_IF_NULL(aut->generators);
+        for(i = 0; i < new_size; i++){
+            aut->generators[i] = aut->generator_storage + i * stride;
+        }
+        aut->allocated_generator_count = new_size;
+    }
+    
+    int *generator = aut->generators[aut->generator_count];
+    expand_flag_map(pg, aut->starting_edge, flag, generator, generator + pg->nv,
+                    workspace->canonical_first_edge, workspace->alternate_first_edge, workspace->queue);
+    generator[pg->nv + pg->ne] = FLAG_IS_REVERSED(aut->starting_edge ^ flag);
+    aut->generator_count++;
+}
+
+/* Stores the orbit of the starting edge under the generators in elements.
+ * Since an automorphism of a connected plane graph is determined by the image
+ * of a single flag, these are exactly the elements of the generated group.
+ * in_orbit should have room for 2*ne elements, and should be FALSE for all flags
+ * except those currently in elements.
+ */
+void compute_starting_edge_orbit(PG_AUTOMORPHISM_GROUP *aut, boolean *in_orbit, int *allocated_elements){
+    int i, j;
+    PLANE_GRAPH *pg = aut->graph;
+    
+    for(i = 0; i < aut->size; i++){
+        in_orbit[aut->elements[i]] = FALSE;
+    }
+    
+    aut->elements[0] = aut->starting_edge;
+    in_orbit[aut->starting_edge] = TRUE;
+    aut->size = 1;
+    
+    for(i = 0; i < aut->size; i++){
+        int flag = aut->elements[i];
+        for(j = 0; j < aut->generator_count; j++){
+            int *edge_image = aut->generators[j] + pg->nv;
+            int image = 2*edge_image[flag/2] + (FLAG_IS_REVERSED(flag) ^ edge_image[pg->ne]);
+            if(!in_orbit[image]){
+                if(aut->size == *allocated_elements){
+                    *allocated_elements *= 2;
+                    aut->elements = (int *)realloc(aut->elements, sizeof(int) * (*allocated_elements));
+                    ABORT_IF_NULL(aut->elements);
+                }
+                in_orbit[image] = TRUE;
+                aut->elements[aut->size++] = image;
+            }
+        }
+    }
+}
+
+PG_AUTOMORPHISM_GROUP *determine_automorphism_generators(PLANE_GRAPH *pg){
+    int i, result, flag;
+    PG_STATS_START(PG_STATS_PHASE_AUTOMORPHISMS);
+    
+    PG_AUTOMORPHISM_GROUP *aut = allocate_automorphism_group(pg);
     PG_AUT_COMP_DATA *workspace = get_automorphism_computation_workspace(pg);
     workspace->has_chiral_group = FALSE;
     
-    //find starting edges
+    boolean *in_orbit = (boolean *)calloc(2 * pg->ne, sizeof(boolean));
+    ABORT_IF_NULL(in_orbit);
+    int allocated_elements = INITIAL_AUTOMORPHISM_CAPACITY;
+    aut->elements = (int *)malloc(sizeof(int) * allocated_elements);
+    ABORT_IF_NULL(aut->elements);
+    
     find_starting_edges(pg, workspace);
     
-    //construct initial certificate
     construct_certificate(pg, workspace->orientation_preserving_starting_edges[0], workspace);
+    aut->starting_edge = FLAG(pg, workspace->orientation_preserving_starting_edges[0], FALSE);
+    compute_starting_edge_orbit(aut, in_orbit, &allocated_elements);
     
-    //look for better automorphism
+    //starting edges in the orbit of the current starting edge give the same
+    //certificate, so they don't need to be checked
     for(i = 1; i < workspace->starting_edges_count; i++){
-        int result = has_better_certificate_orientation_preserving(pg,
-                                                                   workspace->orientation_preserving_starting_edges[i],
-                                                                   aut, workspace);
-        //if result == 1, then the counts are already reset and the new certificate is stored
-        //if result == 0, then the automorphism is already stored
+        flag = FLAG(pg, workspace->orientation_preserving_starting_edges[i], FALSE);
+        if(in_orbit[flag]) continue;
+        result = has_better_certificate_orientation_preserving(pg, workspace->orientation_preserving_starting_edges[i],
+                                                               NULL, workspace);
+        if(result == 1){
+            aut->starting_edge = flag;
+        } else if(result == 0){
+            add_generator(aut, flag, workspace);
+        }
+        if(result >= 0){
+            compute_starting_edge_orbit(aut, in_orbit, &allocated_elements);
+        }
     }
     for(i = 0; i < workspace->starting_edges_count; i++){
-        int result = has_better_certificate_orientation_reversing(pg,
-                                                                  workspace->orientation_reversing_starting_edges[i],
-                                                                  aut, workspace);
-        //if result == 1, then the counts are already reset and the new certificate is stored
-        //if result == 0, then the automorphism is already stored
+        flag = FLAG(pg, workspace->orientation_reversing_starting_edges[i], TRUE);
+        if(in_orbit[flag]) continue;
+        result = has_better_certificate_orientation_reversing(pg, workspace->orientation_reversing_starting_edges[i],
+                                                              NULL, workspace);
+        if(result == 1){
+            aut->starting_edge = flag;
+        } else if(result == 0){
+            add_generator(aut, flag, workspace);
+        }
+        if(result >= 0){
+            compute_starting_edge_orbit(aut, in_orbit, &allocated_elements);
+        }
     }
     
+    aut->orientation_reversing_count = 0;
+    for(i = 0; i < aut->size; i++){
+        if(FLAG_IS_REVERSED(aut->elements[i] ^ aut->starting_edge)){
+            aut->orientation_reversing_count++;
+        }
+    }
+    aut->orientation_preserving_count = aut->size - aut->orientation_reversing_count;
+    
+    free(in_orbit);
+    free_automorphism_computation_workspace(workspace);
+    PG_STATS_STOP(PG_STATS_PHASE_AUTOMORPHISMS);
+    
     return aut;
-}
\ No newline at end of file
+}
+
+void get_automorphism(PG_AUTOMORPHISM_GROUP *aut, int i, int *image){
+    PLANE_GRAPH *pg = aut->graph;
+    
+    if(aut->automorphisms != NULL){
+        memcpy(image, aut->automorphisms[i], sizeof(int) * pg->nv);
+        return;
+    }
+    
+    PG_EDGE **first = (PG_EDGE **)malloc(sizeof(PG_EDGE *) * pg->nv);
+    PG_EDGE **first_image = (PG_EDGE **)malloc(sizeof(PG_EDGE *) * pg->nv);
+    int *queue = (int *)malloc(sizeof(int) * pg->nv);
+    ABORT_IF_NULL(first);
+    ABORT_IF_NULL(first_image);
+    ABORT_IF_NULL(queue);
+    
+    expand_flag_map(pg, aut->starting_edge, aut->elements[i], image, NULL, first, first_image, queue);
+    
+    free(first);
+    free(first_image);
+    free(queue);
+}
+
+void expand_automorphism_group(PG_AUTOMORPHISM_GROUP *aut){
+    int i;
+    PLANE_GRAPH *pg = aut->graph;
+    
+    if(aut->automorphisms != NULL){
+        return;
+    }
+    
+    aut->storage = (int *)malloc(sizeof(int) * pg->nv * aut->size);
+    ABORT_IF_NULL(aut->storage);
+    aut->automorphisms = (int **)malloc(sizeof(int *) * aut->size);
+    ABORT_IF_NULL(aut->automorphisms);
+    aut->allocated_size = aut->size;
+    
+    PG_EDGE **first = (PG_EDGE **)malloc(sizeof(PG_EDGE *) * pg->nv);
+    PG_EDGE **first_image = (PG_EDGE **)malloc(sizeof(PG_EDGE *) * pg->nv);
+    int *queue = (int *)malloc(sizeof(int) * pg->nv);
+    ABORT_IF_NULL(first);
+    ABORT_IF_NULL(first_image);
+    ABORT_IF_NULL(queue);
+    
+    for(i = 0; i < aut->size; i++){
+        aut->automorphisms[i] = aut->storage + i * pg->nv;
+        expand_flag_map(pg, aut->starting_edge, aut->elements[i], aut->automorphisms[i], NULL,
+                        first, first_image, queue);
+    }
+    
+    free(first);
+    free(first_image);
+    free(queue);
+}
+
+int find_orbit_root(int *parent, int x){
+    while(parent[x] != x){
+        parent[x] = parent[parent[x]];
+        x = parent[x];
+    }
+    return x;
+}
+
+/* Merges the orbits of x and y. The root of an orbit is always its smallest
+ * element.
+ */
+void merge_orbits(int *parent, int x, int y){
+    x = find_orbit_root(parent, x);
+    y = find_orbit_root(parent, y);
+    if(x < y){
+        parent[y] = x;
+    } else if(y < x){
+        parent[x] = y;
+    }
+}
+
+/* Merges the orbits of all elements with their images under the automorphism
+ * given by the images of the vertices and of the edges.
+ */
+void merge_orbits_under_automorphism(PLANE_GRAPH *pg, int *image, int *edge_image, boolean reversing,
+                                     int *vertex_parent, int *edge_parent, int *face_parent){
+    int i;
+    
+    for(i = 0; i < pg->nv; i++){
+        merge_orbits(vertex_parent, i, image[i]);
+    }
+    for(i = 0; i < pg->ne; i++){
+        merge_orbits(edge_parent, i, edge_image[i]);
+    }
+    //an orientation reversing automorphism maps the face on the right of an 
+    //edge to the face on the left of its image
+    for(i = 0; i < pg->nf; i++){
+        PG_EDGE *e = pg->edges + edge_image[pg->face_start[i] - pg->edges];
+        merge_orbits(face_parent, i, reversing ? e->inverse->right_face : e->right_face);
+    }
+}
+
+/* Numbers the orbits given by parent in the order of their smallest element.
+ */
+void number_orbits(int *parent, int n, int *orbit, int *orbit_count, int **representatives, int **sizes){
+    int i, count = 0;
+    
+    for(i = 0; i < n; i++){
+        int root = find_orbit_root(parent, i);
+        if(root == i){
+            orbit[i] = count++;
+        } else {
+            orbit[i] = orbit[root];
+        }
+    }
+    
+    *representatives = (int *)malloc(sizeof(int) * (count + 1));
+    ABORT_IF_NULL(*representatives);
+    *sizes = (int *)calloc(count + 1, sizeof(int));
+    ABORT_IF_NULL(*sizes);
+    for(i = n - 1; i >= 0; i--){
+        (*representatives)[orbit[i]] = i;
+        (*sizes)[orbit[i]]++;
+    }
+    *orbit_count = count;
+}
+
+PG_ORBITS *determine_orbits(PG_AUTOMORPHISM_GROUP *aut){
+    int i;
+    PLANE_GRAPH *pg = aut->graph;
+    
+    PG_ORBITS *orbits = (PG_ORBITS *)malloc(sizeof(PG_ORBITS));
+    ABORT_IF_NULL(orbits);
+    
+    int *vertex_parent = (int *)malloc(sizeof(int) * pg->nv);
+    int *edge_parent = (int *)malloc(sizeof(int) * pg->ne);
+    int *face_parent = (int *)malloc(sizeof(int) * (pg->nf + 1));
+    ABORT_IF_NULL(vertex_parent);
+    ABORT_IF_NULL(edge_parent);
+    ABORT_IF_NULL(face_parent);
+    for(i = 0; i < pg->nv; i++){
+        vertex_parent[i] = i;
+    }
+    for(i = 0; i < pg->ne; i++){
+        edge_parent[i] = i;
+    }
+    for(i = 0; i < pg->nf; i++){
+        face_parent[i] = i;
+    }
+    
+    if(aut->generators != NULL){
+        for(i = 0; i < aut->generator_count; i++){
+            int *generator = aut->generators[i];
+            merge_orbits_under_automorphism(pg, generator, generator + pg->nv, generator[pg->nv + pg->ne],
+                                            vertex_parent, edge_parent, face_parent);
+        }
+    } else if(aut->size > 1){
+        //all elements are known, but only their images of the vertices are stored
+        int *image = (int *)malloc(sizeof(int) * pg->nv);
+        int *edge_image = (int *)malloc(sizeof(int) * pg->ne);
+        PG_EDGE **first = (PG_EDGE **)malloc(sizeof(PG_EDGE *) * pg->nv);
+        PG_EDGE **first_image = (PG_EDGE **)malloc(sizeof(PG_EDGE *) * pg->nv);
+        int *queue = (int *)malloc(sizeof(int) * pg->nv);
+        ABORT_IF_NULL(image);
+        ABORT_IF_NULL(edge_image);
+        ABORT_IF_NULL(first);
+        ABORT_IF_NULL(first_image);
+        ABORT_IF_NULL(queue);
+        
+        for(i = 1; i < aut->size; i++){
+            expand_flag_map(pg, aut->starting_edge, aut->elements[i], image, edge_image, first, first_image, queue);
+            merge_orbits_under_automorphism(pg, image, edge_image, 
+                                            FLAG_IS_REVERSED(aut->starting_edge ^ aut->elements[i]),
+                                            vertex_parent, edge_parent, face_parent);
+        }
+        
+        free(image);
+        free(edge_image);
+        free(first);
+        free(first_image);
+        free(queue);
+    }
+    
+    orbits->vertex_orbit = (int *)malloc(sizeof(int) * pg->nv);
+    ABORT_IF_NULL(orbits->vertex_orbit);
+    number_orbits(vertex_parent, pg->nv, orbits->vertex_orbit, &(orbits->vertex_orbit_count),
+                  &(orbits->vertex_orbit_representatives), &(orbits->vertex_orbit_sizes));
+    orbits->edge_orbit = (int *)malloc(sizeof(int) * pg->ne);
+    ABORT_IF_NULL(orbits->edge_orbit);
+    number_orbits(edge_parent, pg->ne, orbits->edge_orbit, &(orbits->edge_orbit_count),
+                  &(orbits->edge_orbit_representatives), &(orbits->edge_orbit_sizes));
+    orbits->face_orbit = (int *)malloc(sizeof(int) * (pg->nf + 1));
+    ABORT_IF_NULL(orbits->face_orbit);
+    number_orbits(face_parent, pg->nf, orbits->face_orbit, &(orbits->face_orbit_count),
+                  &(orbits->face_orbit_representatives), &(orbits->face_orbit_sizes));
+    
+    free(vertex_parent);
+    free(edge_parent);
+    free(face_parent);
+    
+    return orbits;
+}
+
+void free_orbits(PG_ORBITS *orbits){
+    free(orbits->vertex_orbit);
+    free(orbits->vertex_orbit_representatives);
+    free(orbits->vertex_orbit_sizes);
+    free(orbits->edge_orbit);
+    free(orbits->edge_orbit_representatives);
+    free(orbits->edge_orbit_sizes);
+    free(orbits->face_orbit);
+    free(orbits->face_orbit_representatives);
+    free(orbits->face_orbit_sizes);
+    free(orbits);
+}
+
+PG_CANONICAL_FORM *determine_canonical_form_with_workspace(PLANE_GRAPH *pg, PG_AUT_COMP_DATA *workspace){
+    boolean own_workspace = workspace == NULL;
+    if(!pg->faces_constructed){
+        fprintf(stderr, "The faces of the graph have not been constructed.\n");
+        return NULL;
+    }
+    
+    PG_CANONICAL_FORM *form = (PG_CANONICAL_FORM *)malloc(sizeof(PG_CANONICAL_FORM));
+    ABORT_IF_NULL(form);
+    
+    if(own_workspace){
+        workspace = new_automorphism_computation_workspace();
+    }
+    prepare_automorphism_computation_workspace(workspace, pg);
+    
+    determine_minimal_certificate(pg, NULL, workspace);
+    
+    form->nv = pg->nv;
+    form->certificate_length = pg->ne + pg->nv;
+    form->mirrored = workspace->has_chiral_group;
+    if(own_workspace){
+        //the workspace arrays are handed over to the canonical form
+        form->certificate = workspace->certificate;
+        form->canonical_labelling = workspace->canonical_labelling;
+        workspace->certificate = NULL;
+        workspace->canonical_labelling = NULL;
+        free_automorphism_computation_workspace(workspace);
+    } else {
+        //the workspace is reused by the caller, so its arrays are copied
+        form->certificate = (int *)malloc(sizeof(int) * form->certificate_length);
+        ABORT_IF_NULL(form->certificate);
+        memcpy(form->certificate, workspace->certificate, sizeof(int) * form->certificate_length);
+        form->canonical_labelling = (int *)malloc(sizeof(int) * pg->nv);
+        ABORT_IF_NULL(form->canonical_labelling);
+        memcpy(form->canonical_labelling, workspace->canonical_labelling, sizeof(int) * pg->nv);
+    }
+    
+    return form;
+}
+
+PG_CANONICAL_FORM *determine_canonical_form(PLANE_GRAPH *pg){
+    return determine_canonical_form_with_workspace(pg, NULL);
+}
+
+void free_canonical_form(PG_CANONICAL_FORM *form){
+    free(form->certificate);
+    free(form->canonical_labelling);
+    free(form);
+}
@@ -13,6 +13,9 @@
 typedef struct __pg_automorphism_group PG_AUTOMORPHISM_GROUP;
 
 struct __pg_automorphism_group {
+    //all automorphisms: automorphisms[i][v] is the image of v under the i-th
+    //automorphism, and automorphisms[0] is the identity. This is NULL if only
+    //the generators were determined (see determine_automorphism_generators).
     int **automorphisms;
     int size;
     int orientation_preserving_count;
@@ -21,12 +24,191 @@ struct __pg_automorphism_group {
     PLANE_GRAPH *graph;
     
     int allocated_size;
+    //the contiguous buffer in which the automorphisms are stored
+    int *storage;
+    
+    //a generating set of the group: generators[i][v] is the image of v under
+    //the i-th generator. This is NULL if all automorphisms were determined.
+    int **generators;
+    int generator_count;
+    int allocated_generator_count;
+    int *generator_storage;
+    
+    //the flags of the elements of the group: a flag is 2 times the index of an 
+    //edge in graph->edges, plus 1 if the rotations are traversed in counterclockwise
+    //order. If only the generators were determined, then element i maps the flag
+    //starting_edge to the flag elements[i]. Otherwise automorphisms[i] maps the 
+    //flag elements[i] to the flag starting_edge.
+    int *elements;
+    int starting_edge;
 };
 
+/**
+ * Determines all automorphisms of the graph. The faces of the graph should 
+ * be constructed. The memory used by the group is proportional to its size.
+ * @param pg
+ * @return the automorphism group, which should be freed with free_automorphism_group
+ */
 PG_AUTOMORPHISM_GROUP *determine_automorphisms(PLANE_GRAPH *pg);
 
+/**
+ * Determines all automorphisms of the graph using several threads: the 
+ * starting edges are divided among the threads, and each thread uses its own
+ * workspace. The result is exactly the same as that of determine_automorphisms,
+ * including the order of the automorphisms. The faces of the graph should be
+ * constructed.
+ * @param pg
+ * @param thread_count the number of threads (including the calling thread)
+ * @return the automorphism group, which should be freed with free_automorphism_group
+ */
+PG_AUTOMORPHISM_GROUP *determine_automorphisms_parallel(PLANE_GRAPH *pg, int thread_count);
+
+/**
+ * Determines a generating set of the automorphism group of the graph. The 
+ * faces of the graph should be constructed. Only the generators are stored 
+ * as mappings of the vertices, and the other elements can be obtained with
+ * get_automorphism or expand_automorphism_group. The size of the group and the
+ * number of orientation preserving and reversing automorphisms are determined.
+ * The graph should not be changed as long as the group is used.
+ * @param pg
+ * @return the automorphism group, which should be freed with free_automorphism_group
+ */
+PG_AUTOMORPHISM_GROUP *determine_automorphism_generators(PLANE_GRAPH *pg);
+
+/**
+ * Stores the images of the vertices under the i-th automorphism in image.
+ * This works for groups which only store the generators, and for groups which
+ * store all automorphisms.
+ * @param aut
+ * @param i a number between 0 and aut->size - 1 (0 is the identity)
+ * @param image an array with room for nv elements
+ */
+void get_automorphism(PG_AUTOMORPHISM_GROUP *aut, int i, int *image);
+
+/**
+ * Stores all automorphisms of a group of which only the generators were
+ * determined in aut->automorphisms.
+ * @param aut
+ */
+void expand_automorphism_group(PG_AUTOMORPHISM_GROUP *aut);
+
 void free_automorphism_group(PG_AUTOMORPHISM_GROUP *aut);
 
+/* The scratch space used to compute automorphisms. A workspace can be reused
+ * for graphs of different sizes: it grows when needed. A workspace can only be
+ * used by one thread at a time.
+ */
+typedef struct __pg_aut_comp_data PG_AUT_COMP_DATA;
+
+PG_AUT_COMP_DATA *new_automorphism_computation_workspace();
+
+void free_automorphism_computation_workspace(PG_AUT_COMP_DATA *workspace);
+
+/**
+ * Determines the order of the automorphism group of the graph without storing
+ * any automorphism. The faces of the graph should be constructed. If threshold
+ * is positive, then the computation stops as soon as it is known that the 
+ * group contains at least threshold automorphisms. In that case the returned
+ * value is threshold and the counts of orientation preserving and reversing
+ * automorphisms are only those that were found so far.
+ * @param pg
+ * @param threshold the order at which to stop, or 0 to determine the exact order
+ * @param orientation_preserving_count if not NULL, the number of orientation 
+ *        preserving automorphisms is stored here
+ * @param orientation_reversing_count if not NULL, the number of orientation 
+ *        reversing automorphisms is stored here
+ * @param workspace a workspace created with new_automorphism_computation_workspace,
+ *        or NULL to use a temporary workspace
+ * @return the order of the automorphism group, or threshold if the order is at 
+ *         least threshold
+ */
+int count_automorphisms(PLANE_GRAPH *pg, int threshold, int *orientation_preserving_count,
+                        int *orientation_reversing_count, PG_AUT_COMP_DATA *workspace);
+
+typedef struct __pg_orbits PG_ORBITS;
+
+/* The orbits of the vertices, the oriented edges and the faces under an
+ * automorphism group. The orbits of each type are numbered from 0 in the order 
+ * of their smallest element, and this smallest element is the representative
+ * of the orbit. Oriented edges are identified by their index in graph->edges.
+ */
+struct __pg_orbits {
+    //vertex_orbit[v] is the number of the orbit of vertex v
+    int *vertex_orbit;
+    int vertex_orbit_count;
+    int *vertex_orbit_representatives;
+    int *vertex_orbit_sizes;
+    
+    //edge_orbit[i] is the number of the orbit of the edge graph->edges[i]
+    int *edge_orbit;
+    int edge_orbit_count;
+    int *edge_orbit_representatives;
+    int *edge_orbit_sizes;
+    
+    //face_orbit[f] is the number of the orbit of face f
+    int *face_orbit;
+    int face_orbit_count;
+    int *face_orbit_representatives;
+    int *face_orbit_sizes;
+};
+
+/**
+ * Determines the orbits of the vertices, the oriented edges and the faces 
+ * under the given group. If only the generators of the group were determined,
+ * then the orbits are determined from the generators only. The faces of the 
+ * graph should still be the faces for which the group was determined.
+ * @param aut
+ * @return the orbits, which should be freed with free_orbits
+ */
+PG_ORBITS *determine_orbits(PG_AUTOMORPHISM_GROUP *aut);
+
+void free_orbits(PG_ORBITS *orbits);
+
+typedef struct __pg_canonical_form PG_CANONICAL_FORM;
+
+/* The canonical form of a plane graph. Two plane graphs have the same 
+ * certificate if and only if they are isomorphic, where an isomorphism can
+ * either preserve or reverse the orientation.
+ */
+struct __pg_canonical_form {
+    int nv;
+    
+    //for each vertex in canonical order the canonical numbers of its neighbours
+    //in (possibly mirrored) clockwise order, followed by INT_MAX
+    int *certificate;
+    int certificate_length;
+    
+    //canonical_labelling[v] is the canonical number of vertex v
+    int *canonical_labelling;
+    
+    //TRUE if the certificate lists the neighbours in counterclockwise order
+    boolean mirrored;
+};
+
+/**
+ * Determines the canonical form of the given graph. The faces of the graph
+ * should be constructed. The graph should be connected.
+ * @param pg
+ * @return the canonical form, which should be freed with free_canonical_form,
+ *         or NULL if the faces of the graph have not been constructed
+ */
+PG_CANONICAL_FORM *determine_canonical_form(PLANE_GRAPH *pg);
+
+/**
+ * Determines the canonical form of the given graph using the given workspace.
+ * This avoids allocating a new workspace for each graph when the canonical
+ * forms of many graphs are determined. The result is the same as that of
+ * determine_canonical_form.
+ * @param pg
+ * @param workspace a workspace created with new_automorphism_computation_workspace,
+ *        or NULL to use a temporary workspace
+ * @return the canonical form, which should be freed with free_canonical_form,
+ *         or NULL if the faces of the graph have not been constructed
+ */
+PG_CANONICAL_FORM *determine_canonical_form_with_workspace(PLANE_GRAPH *pg, PG_AUT_COMP_DATA *workspace);
+
+void free_canonical_form(PG_CANONICAL_FORM *form);
+
 
 #endif	/* PLANEGRAPH_AUTOMORPHISMGROUP_H */
 
@@ -8,8 +8,81 @@
 #include "planegraphs_base.h"
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
 #include <limits.h>
 
+/**
+ * Returns the number of faces for which there is room in a graph with room
+ * for maxe oriented edges: a connected graph with m edges has at most m + 1
+ * faces.
+ */
+static int default_face_capacity(int maxe){
+    return maxe/2 + 2;
+}
+
+/**
+ * Allocates a single block of memory that contains all arrays of the graph:
+ * the edges, the first edge and the degree of each vertex, and the start edge
+ * and the size of each face. Any previous block of the graph is freed, so the
+ * graph is empty afterwards.
+ * @return FALSE if insufficient memory was available. In that case the
+ *         previous block and the capacity of the graph are unchanged.
+ */
+static boolean allocate_plane_graph_arena(PLANE_GRAPH *pg, int maxn, int maxe, int maxf){
+    //the arrays of pointers come first, so all arrays are correctly aligned
+    size_t size = sizeof(PG_EDGE) * (size_t)maxe +
+            sizeof(PG_EDGE *) * ((size_t)maxn + maxf) +
+            sizeof(int) * ((size_t)maxn + maxf);
+    
+    void *arena = malloc(size);
+    
+    if(arena == NULL){
+        return FALSE;
+    }
+    
+    free(pg->edges);
+    
+    pg->edges = (PG_EDGE *)arena;
+    pg->first_edge = (PG_EDGE **)(pg->edges + maxe);
+    pg->face_start = pg->first_edge + maxn;
+    pg->degree = (int *)(pg->face_start + maxf);
+    pg->face_size = pg->degree + maxn;
+    
+    pg->maxn = maxn;
+    pg->maxe = maxe;
+    pg->maxf = maxf;
+    
+    pg->nv = pg->ne = pg->nf = 0;
+    pg->faces_constructed = FALSE;
+    //the marks of the new edges are not initialised
+    pg->mark_value = 30000;
+    
+    return TRUE;
+}
+
+/**
+ * Creates a new graph with the given capacities, without any checks on them.
+ */
+static PLANE_GRAPH *allocate_plane_graph(int maxn, int maxe, int maxf){
+    PLANE_GRAPH *pg = (PLANE_GRAPH *)malloc(sizeof(PLANE_GRAPH));
+    
+    if(pg == NULL){
+        fprintf(stderr, "Insufficient memory for plane_graph -- exiting!\n");
+        return NULL;
+    }
+    
+    pg->edges = NULL;
+    
+    if(!allocate_plane_graph_arena(pg, maxn, maxe, maxf)){
+        fprintf(stderr, "Insufficient memory for the arrays of the plane_graph -- exiting!\n");
+        free(pg);
+        return NULL;
+    }
+    
+    return pg;
+}
+
 PLANE_GRAPH *new_plane_graph(int maxn, int maxe) {
     if(maxn <= 0){
         fprintf(stderr, "maxn should be a positive integer -- exiting!\n");
@@ -20,68 +93,345 @@ PLANE_GRAPH *new_plane_graph(int maxn, int maxe) {
         maxe = 6*maxn-12;
     }
     
-    PLANE_GRAPH *pg = (PLANE_GRAPH *)malloc(sizeof(PLANE_GRAPH));
+    if(maxe < 0){
+        maxe = 0;
+    }
     
-    if(pg == NULL){
-        fprintf(stderr, "Insufficient memory for plane_graph -- exiting!\n");
+    return allocate_plane_graph(maxn, maxe, default_face_capacity(maxe));
+}
+
+void free_plane_graph(PLANE_GRAPH *pg){
+    //all arrays are stored in the same block as the edges
+    free(pg->edges);
+    free(pg);
+}
+
+boolean reset_plane_graph(PLANE_GRAPH *pg, int maxn, int maxe){
+    pg->nv = pg->ne = pg->nf = 0;
+    pg->faces_constructed = FALSE;
+    
+    if(maxe <= 0){
+        maxe = 6*maxn-12;
+    }
+    
+    if(maxe < 0){
+        maxe = 0;
+    }
+    
+    if(maxe <= pg->maxe && maxn <= pg->maxn && default_face_capacity(maxe) <= pg->maxf){
+        return TRUE;
+    }
+    
+    //the capacities never shrink
+    if(maxe < pg->maxe){
+        maxe = pg->maxe;
+    }
+    if(maxn < pg->maxn){
+        maxn = pg->maxn;
+    }
+    int maxf = default_face_capacity(maxe);
+    if(maxf < pg->maxf){
+        maxf = pg->maxf;
+    }
+    
+    if(!allocate_plane_graph_arena(pg, maxn, maxe, maxf)){
+        fprintf(stderr, "Insufficient memory for plane_graph.\n");
+        return FALSE;
+    }
+    
+    return TRUE;
+}
+
+/**
+ * Copies the used part of the arrays of source to target, which should have
+ * room for them, and makes the pointers refer to the edges of target.
+ */
+static void copy_plane_graph_arrays(PLANE_GRAPH *target, PLANE_GRAPH *source){
+    int i;
+    PG_EDGE *edges = target->edges;
+    
+    memcpy(edges, source->edges, sizeof(PG_EDGE) * source->ne);
+    for(i = 0; i < source->ne; i++){
+        edges[i].next = edges + (edges[i].next - source->edges);
+        edges[i].prev = edges + (edges[i].prev - source->edges);
+        edges[i].inverse = edges + (edges[i].inverse - source->edges);
+    }
+    //the edges that are not used yet should never seem marked
+    for(i = source->ne; i < target->maxe; i++){
+        edges[i].mark = 0;
+    }
+    
+    memcpy(target->degree, source->degree, sizeof(int) * source->nv);
+    for(i = 0; i < source->nv; i++){
+        target->first_edge[i] = edges + (source->first_edge[i] - source->edges);
+    }
+    
+    if(source->faces_constructed){
+        memcpy(target->face_size, source->face_size, sizeof(int) * source->nf);
+        for(i = 0; i < source->nf; i++){
+            target->face_start[i] = edges + (source->face_start[i] - source->edges);
+        }
+    }
+    
+    target->nv = source->nv;
+    target->ne = source->ne;
+    target->nf = source->nf;
+    target->faces_constructed = source->faces_constructed;
+    target->mark_value = source->mark_value;
+}
+
+PLANE_GRAPH *clone_plane_graph(PLANE_GRAPH *pg){
+    PLANE_GRAPH *clone = allocate_plane_graph(pg->maxn, pg->maxe, pg->maxf);
+    
+    if(clone == NULL){
         return NULL;
     }
     
-    pg->maxn = maxn;
-    pg->maxe = maxe;
+    copy_plane_graph_arrays(clone, pg);
     
-    pg->nv = pg->ne = pg->nf = 0;
+    return clone;
+}
+
+boolean copy_plane_graph(PLANE_GRAPH *target, PLANE_GRAPH *source){
+    if(target->maxn < source->nv || target->maxe < source->ne ||
+            (source->faces_constructed && target->maxf < source->nf)){
+        int maxn = target->maxn > source->maxn ? target->maxn : source->maxn;
+        int maxe = target->maxe > source->maxe ? target->maxe : source->maxe;
+        int maxf = target->maxf > source->maxf ? target->maxf : source->maxf;
+        if(!allocate_plane_graph_arena(target, maxn, maxe, maxf)){
+            fprintf(stderr, "Insufficient memory for plane_graph.\n");
+            return FALSE;
+        }
+    }
     
-    pg->edges = (PG_EDGE *)malloc(sizeof(PG_EDGE)*maxe);
+    copy_plane_graph_arrays(target, source);
     
-    if(pg->edges == NULL){
-        fprintf(stderr, "Insufficient memory for edges -- exiting!\n");
-        free(pg);
+    return TRUE;
+}
+
+//----------------BLOBS--------------------
+
+static const char BLOB_MAGIC[8] = {'P', 'G', 'B', 'L', 'O', 'B', '0', '1'};
+
+//the number of integers in the header of a blob after the magic: nv, ne, nf,
+//faces_constructed and mark_value
+#define BLOB_HEADER_INTS 5
+
+//the number of integers stored for each edge: start, end, right_face, next,
+//prev, inverse, index, colour and mark
+#define BLOB_EDGE_INTS 9
+
+size_t plane_graph_blob_size(PLANE_GRAPH *pg){
+    size_t ints = BLOB_HEADER_INTS + BLOB_EDGE_INTS * (size_t)pg->ne + 2 * (size_t)pg->nv;
+    if(pg->faces_constructed){
+        ints += 2 * (size_t)pg->nf;
+    }
+    return sizeof(BLOB_MAGIC) + sizeof(int32_t) * ints;
+}
+
+size_t export_plane_graph_blob(PLANE_GRAPH *pg, void *blob, size_t capacity){
+    int i;
+    size_t size = plane_graph_blob_size(pg);
+    
+    if(size > capacity){
+        return 0;
+    }
+    
+    memcpy(blob, BLOB_MAGIC, sizeof(BLOB_MAGIC));
+    int32_t *position = (int32_t *)((char *)blob + sizeof(BLOB_MAGIC));
+    
+    *position++ = pg->nv;
+    *position++ = pg->ne;
+    *position++ = pg->faces_constructed ? pg->nf : 0;
+    *position++ = pg->faces_constructed;
+    *position++ = pg->mark_value;
+    
+    for(i = 0; i < pg->ne; i++){
+        PG_EDGE *e = pg->edges + i;
+        *position++ = e->start;
+        *position++ = e->end;
+        *position++ = pg->faces_constructed ? e->right_face : -1;
+        *position++ = e->next - pg->edges;
+        *position++ = e->prev - pg->edges;
+        *position++ = e->inverse - pg->edges;
+        *position++ = e->index;
+        *position++ = e->colour;
+        *position++ = e->mark;
+    }
+    
+    for(i = 0; i < pg->nv; i++){
+        *position++ = pg->first_edge[i] - pg->edges;
+        *position++ = pg->degree[i];
+    }
+    
+    if(pg->faces_constructed){
+        for(i = 0; i < pg->nf; i++){
+            *position++ = pg->face_start[i] - pg->edges;
+            *position++ = pg->face_size[i];
+        }
+    }
+    
+    return size;
+}
+
+/**
+ * Checks that a number read from a blob lies in [0, bound).
+ */
+static inline boolean is_in_range(int32_t value, int bound){
+    return value >= 0 && value < bound;
+}
+
+/**
+ * Checks that the edges, rotations and faces of a graph read from a blob fit
+ * together, so that all walks through the graph stay within the graph and end.
+ * All pointers are assumed to point into the used part of the arrays. This takes
+ * linear time.
+ */
+static boolean has_consistent_structure(PLANE_GRAPH *pg){
+    int i, steps;
+    size_t total;
+    PG_EDGE *e;
+    
+    for(i = 0; i < pg->ne; i++){
+        e = pg->edges + i;
+        if(e->inverse == e || e->inverse->inverse != e || 
+                e->inverse->start != e->end || e->inverse->end != e->start ||
+                e->next->prev != e || e->prev->next != e || e->next->start != e->start){
+            return FALSE;
+        }
+    }
+    
+    //next is a permutation of the edges, so its cycles are disjoint: the 
+    //rotations cover all edges if their lengths add up to the number of edges
+    total = 0;
+    for(i = 0; i < pg->nv; i++){
+        e = pg->first_edge[i];
+        steps = 0;
+        do {
+            if(e->start != i || ++steps > pg->degree[i]){
+                return FALSE;
+            }
+            e = e->next;
+        } while(e != pg->first_edge[i]);
+        if(steps != pg->degree[i]){
+            return FALSE;
+        }
+        total += steps;
+    }
+    if(total != (size_t)pg->ne){
+        return FALSE;
+    }
+    
+    if(!pg->faces_constructed){
+        return TRUE;
+    }
+    
+    total = 0;
+    for(i = 0; i < pg->nf; i++){
+        e = pg->face_start[i];
+        steps = 0;
+        do {
+            if(e->right_face != i || ++steps > pg->face_size[i]){
+                return FALSE;
+            }
+            e = e->inverse->prev;
+        } while(e != pg->face_start[i]);
+        if(steps != pg->face_size[i]){
+            return FALSE;
+        }
+        total += steps;
+    }
+    return total == (size_t)pg->ne;
+}
+
+PLANE_GRAPH *import_plane_graph_blob(const void *blob, size_t size){
+    int i;
+    
+    if(size < sizeof(BLOB_MAGIC) + sizeof(int32_t) * BLOB_HEADER_INTS ||
+            memcmp(blob, BLOB_MAGIC, sizeof(BLOB_MAGIC)) != 0){
+        fprintf(stderr, "Not a plane graph blob.\n");
         return NULL;
     }
     
-    pg->first_edge = (PG_EDGE **)malloc(sizeof(PG_EDGE *) * maxn);
+    const int32_t *position = (const int32_t *)((const char *)blob + sizeof(BLOB_MAGIC));
+    int nv = *position++;
+    int ne = *position++;
+    int nf = *position++;
+    boolean faces_constructed = *position++;
+    int mark_value = *position++;
     
-    if(pg->first_edge == NULL){
-        fprintf(stderr, "Insufficient memory for firstedges -- exiting!\n");
-        free(pg->edges);
-        free(pg);
+    if(nv < 0 || ne < 0 || nf < 0 || (faces_constructed != FALSE && faces_constructed != TRUE) ||
+            (!faces_constructed && nf != 0) ||
+            size != sizeof(BLOB_MAGIC) + sizeof(int32_t) * (BLOB_HEADER_INTS +
+            BLOB_EDGE_INTS * (size_t)ne + 2 * (size_t)nv + (faces_constructed ? 2 * (size_t)nf : 0))){
+        fprintf(stderr, "Corrupt plane graph blob.\n");
         return NULL;
     }
     
-    pg->degree = (int *)malloc(sizeof(int)*maxn);
+    int maxf = default_face_capacity(ne) > nf ? default_face_capacity(ne) : nf;
+    PLANE_GRAPH *pg = allocate_plane_graph(nv > 0 ? nv : 1, ne, maxf);
     
-    if(pg->degree == NULL){
-        fprintf(stderr, "Insufficient memory for degrees -- exiting!\n");
-        free(pg->degree);
-        free(pg->edges);
-        free(pg);
+    if(pg == NULL){
         return NULL;
     }
     
-    //by default the dual is not yet initialised
-    pg->maxf = 0;
-    pg->face_start = NULL;
-    pg->face_size = NULL;
-    pg->faces_constructed = FALSE;
-    pg->mark_value = 30000;
+    boolean valid = TRUE;
     
-    return pg;
-}
-
-void free_plane_graph(PLANE_GRAPH *pg){
-    if(pg->face_start != NULL){
-        free(pg->face_start);
+    for(i = 0; i < ne; i++){
+        PG_EDGE *e = pg->edges + i;
+        const int32_t *entry = position + BLOB_EDGE_INTS * (size_t)i;
+        valid = valid && is_in_range(entry[0], nv) && is_in_range(entry[1], nv) &&
+                (!faces_constructed || is_in_range(entry[2], nf)) && 
+                is_in_range(entry[3], ne) && is_in_range(entry[4], ne) && is_in_range(entry[5], ne);
+        if(!valid){
+            break;
+        }
+        e->start = entry[0];
+        e->end = entry[1];
+        e->right_face = entry[2];
+        e->next = pg->edges + entry[3];
+        e->prev = pg->edges + entry[4];
+        e->inverse = pg->edges + entry[5];
+        e->index = entry[6];
+        e->colour = entry[7];
+        e->mark = entry[8];
+        e->label = NULL;
     }
+    position += BLOB_EDGE_INTS * (size_t)ne;
     
-    if(pg->face_size != NULL){
-        free(pg->face_size);
+    for(i = 0; valid && i < nv; i++){
+        valid = is_in_range(position[2*i], ne);
+        pg->first_edge[i] = pg->edges + position[2*i];
+        pg->degree[i] = position[2*i + 1];
     }
+    position += 2 * (size_t)nv;
     
-    free(pg->degree);
-    free(pg->first_edge);
-    free(pg->edges);
-    free(pg);
+    if(faces_constructed){
+        for(i = 0; valid && i < nf; i++){
+            valid = is_in_range(position[2*i], ne);
+            pg->face_start[i] = pg->edges + position[2*i];
+            pg->face_size[i] = position[2*i + 1];
+        }
+    }
+    
+    pg->nv = nv;
+    pg->ne = ne;
+    pg->nf = nf;
+    pg->faces_constructed = faces_constructed;
+    pg->mark_value = mark_value;
+    
+    if(!valid || !has_consistent_structure(pg)){
+        fprintf(stderr, "Corrupt plane graph blob.\n");
+        free_plane_graph(pg);
+        return NULL;
+    }
+    
+    //the marks of the edges that are not used yet should be below mark_value
+    for(i = ne; i < pg->maxe; i++){
+        pg->edges[i].mark = 0;
+    }
+    
+    return pg;
 }
 
 /**
@@ -126,34 +476,14 @@ PG_EDGE *find_edge(PLANE_GRAPH *pg, int from, int to) {
 void construct_faces(PLANE_GRAPH *pg) {
     register int i, sz;
     register PG_EDGE *e, *ex, *ef, *efx;
-
-    RESETMARKS(pg);
+    PG_STATS_START(PG_STATS_PHASE_CONSTRUCT_FACES);
     
-    //first allocate the memory to store faces if this has not yet been done
-    int maxf = 2*pg->maxn - 4;
-    if(pg->maxf < maxf){
-        if(pg->face_start != NULL){
-            free(pg->face_start);
-        }
-        if(pg->face_size != NULL){
-            free(pg->face_size);
-        }
-        pg->maxf = maxf;
-        
-        pg->face_start = (PG_EDGE **)malloc(sizeof(PG_EDGE *) * maxf);
-        
-        if(pg->face_start == NULL){
-            pg->maxf = 0;
-            return;
-        }
-        
-        pg->face_size = (int *)malloc(sizeof(int) * maxf);
-        
-        if(pg->face_size == NULL){
-            pg->maxf = 0;
-            free(pg->face_start);
-            return;
-        }
+    //the arrays for the faces are allocated together with the edges, and
+    //there is room for the faces of any connected graph that fits in the arrays
+    //an edge without a face yet is recognised by its negative face number,
+    //so the marks of the edges are left untouched
+    for (i = 0; i < pg->ne; ++i) {
+        pg->edges[i].right_face = -1;
     }
 
     int nf = 0;
@@ -161,12 +491,11 @@ void construct_faces(PLANE_GRAPH *pg) {
 
         e = ex = pg->first_edge[i];
         do {
-            if (!ISMARKEDLO(pg, e)) {
+            if (e->right_face < 0) {
                 pg->face_start[nf] = ef = efx = e;
                 sz = 0;
                 do {
                     ef->right_face = nf;
-                    MARKLO(pg, ef);
                     ef = ef->inverse->prev;
                     ++sz;
                 } while (ef != efx);
@@ -178,6 +507,7 @@ void construct_faces(PLANE_GRAPH *pg) {
     }
     pg->nf = nf;
     pg->faces_constructed = TRUE;
+    PG_STATS_STOP(PG_STATS_PHASE_CONSTRUCT_FACES);
 }
 
 void clear_all_edge_labels(PLANE_GRAPH *pg){
@@ -192,20 +522,19 @@ PLANE_GRAPH *get_dual_graph(PLANE_GRAPH *pg){
     int i;
     
     if(!pg->faces_constructed){
-        construct_faces(pg);
+        fprintf(stderr, "The faces of the graph have not been constructed.\n");
+        return NULL;
     }
     
-    PLANE_GRAPH *dual = new_plane_graph(pg->nf, pg->ne);
+    //the dual has exactly as many edges as the graph, even if the dual has
+    //more edges than a simple plane graph with that number of vertices
+    PLANE_GRAPH *dual = allocate_plane_graph(pg->nf, pg->ne, pg->nv);
     
     if(dual==NULL){
         fprintf(stderr, "Insufficient memory to create dual.\n");
         return NULL;
     }
     
-    for(i = 0; i < pg->ne; i++){
-        pg->edges[i].index = i;
-    }
-    
     dual->nv = pg->nf;
     dual->ne = pg->ne;
     dual->nf = pg->nv;
@@ -215,36 +544,20 @@ PLANE_GRAPH *get_dual_graph(PLANE_GRAPH *pg){
         dual->edges[i].end = pg->edges[i].inverse->right_face;
         dual->edges[i].right_face = pg->edges[i].end;
         
-        dual->edges[i].inverse = dual->edges + pg->edges[i].inverse->index;
-        dual->edges[i].next = dual->edges + pg->edges[i].inverse->prev->index;
-        dual->edges[i].prev = dual->edges + pg->edges[i].next->inverse->index;
+        //the dual of an edge has the same position in the array of edges
+        dual->edges[i].inverse = dual->edges + (pg->edges[i].inverse - pg->edges);
+        dual->edges[i].next = dual->edges + (pg->edges[i].inverse->prev - pg->edges);
+        dual->edges[i].prev = dual->edges + (pg->edges[i].next->inverse - pg->edges);
     }
     
     for(i = 0; i < pg->nf; i++){
         dual->degree[i] = pg->face_size[i];
-        dual->first_edge[i] = dual->edges + pg->face_start[i]->index;
-    }
-    
-    dual->maxf = pg->nv;
-    
-    dual->face_start = (PG_EDGE **)malloc(sizeof(PG_EDGE *) * (dual->maxf));
-        
-    if(dual->face_start == NULL){
-        dual->maxf = 0;
-        return dual;
-    }
-
-    dual->face_size = (int *)malloc(sizeof(int) * (dual->maxf));
-
-    if(dual->face_size == NULL){
-        dual->maxf = 0;
-        free(dual->face_start);
-        return dual;
+        dual->first_edge[i] = dual->edges + (pg->face_start[i] - pg->edges);
     }
     
     for(i = 0; i < pg->nv; i++){
         dual->face_size[i] = pg->degree[i];
-        dual->face_start[i] = dual->edges + pg->first_edge[i]->inverse->index;
+        dual->face_start[i] = dual->edges + (pg->first_edge[i]->inverse - pg->edges);
     }
     
     dual->faces_constructed = TRUE;
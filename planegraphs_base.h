@@ -8,6 +8,9 @@
 #ifndef PLANEGRAPH_BASE_H
 #define	PLANEGRAPH_BASE_H
 
+#include <stddef.h>
+#include "planegraphs_stats.h"
+
 #define FALSE 0
 #define TRUE  1
 
@@ -33,7 +36,9 @@ struct __pg_edge {
      */
     int index, colour;
 
-    /* Only access mark via the MARK macros.
+    /* Only access mark via the MARK macros. The algorithms of the library
+     * that only read the graph store their marks in a scratch context (see
+     * planegraphs_scratch.h), so these marks are never changed by them.
      */
     int mark;
     
@@ -67,7 +72,10 @@ struct __plane_graph {
     //an array containing the size of each face
     int *face_size;
     
-    //TRUE if the faces of this graph have been constructed
+    //TRUE if the faces of this graph have been constructed. Functions that need
+    //the faces do not construct them, but fail if they are missing, so that a
+    //graph is never modified by a read-only function. The faces should thus be
+    //constructed before a graph is shared between threads.
     boolean faces_constructed;
     
     //should be set to 30000 for a new graph
@@ -75,7 +83,8 @@ struct __plane_graph {
 };
 
 #define RESETMARKS(pg) {int mki; if (((pg)->mark_value += 2) > 30000) \
-       { (pg)->mark_value = 2; for (mki=0;mki<(pg)->maxe;++mki) (pg)->edges[mki].mark=0;}}
+       { (pg)->mark_value = 2; for (mki=0;mki<(pg)->maxe;++mki) (pg)->edges[mki].mark=0; \
+         PG_STATS_ADD(PG_STATS_MARK_WRAPS, 1);}}
 #define MARK(pg, e) (e)->mark = (pg)->mark_value
 #define MARKLO(pg, e) (e)->mark = (pg)->mark_value
 #define MARKHI(pg, e) (e)->mark = (pg)->mark_value+1
@@ -87,7 +96,8 @@ struct __plane_graph {
 /**
  * Creates a new planar graph data structure that can hold plane graphs with
  * up to maxn vertices and maxe oriented edges. If maxe is zero, then the 
- * theoretical maximum for maxn is computed and used.
+ * theoretical maximum for maxn is computed and used. All arrays of the graph,
+ * including those for the faces, are stored in a single block of memory.
  * 
  * This function might return a NULL pointer if insufficient memory was
  * available or the number of vertices is illegal.
@@ -101,7 +111,80 @@ PLANE_GRAPH *new_plane_graph(int maxn, int maxe);
 void free_plane_graph(PLANE_GRAPH *pg);
 
 /**
- *
+ * Empties an existing plane graph so that it can be reused for a graph with 
+ * up to maxn vertices and maxe oriented edges. The arrays of the graph are
+ * only reallocated if they are too small, so a graph can be reused for many
+ * graphs without allocating memory each time. If maxe is zero, then the 
+ * theoretical maximum for maxn is computed and used.
+ * 
+ * @param pg
+ * @param maxn the maximum number of vertices this plane graph will contain
+ * @param maxe the maximum number of oriented edges this plane graph will contain,
+ *             or zero if the theoretical maximum should be used
+ * @return FALSE if insufficient memory was available. In that case the graph
+ *         is still empty, but the capacity is unchanged.
+ */
+boolean reset_plane_graph(PLANE_GRAPH *pg, int maxn, int maxe);
+
+/**
+ * Creates a copy of the graph with the same capacities. The pointers of the
+ * copy refer to its own edges, but the labels of the edges are shared with
+ * the original graph. This takes time linear in the size of the graph.
+ * 
+ * This function might return a NULL pointer if insufficient memory was
+ * available.
+ * 
+ * @param pg
+ */
+PLANE_GRAPH *clone_plane_graph(PLANE_GRAPH *pg);
+
+/**
+ * Replaces the graph target by a copy of the graph source. No memory is
+ * allocated if target has room for source, so this can be used to restore a
+ * snapshot of a graph many times, e.g., during backtracking.
+ * @param target
+ * @param source
+ * @return FALSE if insufficient memory was available. In that case target
+ *         is unchanged.
+ */
+boolean copy_plane_graph(PLANE_GRAPH *target, PLANE_GRAPH *source);
+
+/**
+ * Returns the number of bytes needed to export the graph as a blob.
+ * @param pg
+ */
+size_t plane_graph_blob_size(PLANE_GRAPH *pg);
+
+/**
+ * Stores the graph in a blob: a block of memory that refers to edges by their
+ * position instead of by a pointer, so it can be moved to another address or
+ * to another process, e.g., through shared memory. The numbers are stored in
+ * the byte order of this machine, and the blob should be aligned to 4 bytes.
+ * The labels of the edges are not stored.
+ * @param pg
+ * @param blob
+ * @param capacity the number of bytes available in the blob
+ * @return the number of bytes written, or 0 if the blob is too small
+ */
+size_t export_plane_graph_blob(PLANE_GRAPH *pg, void *blob, size_t capacity);
+
+/**
+ * Creates a graph from a blob that was created by export_plane_graph_blob.
+ * 
+ * This function might return a NULL pointer if insufficient memory was
+ * available or the blob is not valid. A blob is only valid if its edges form a
+ * plane graph: the inverses, rotations and (if present) faces are checked 
+ * against each other in linear time, so blobs from untrusted sources can be 
+ * imported safely.
+ * 
+ * @param blob
+ * @param size the size of the blob in bytes
+ */
+PLANE_GRAPH *import_plane_graph_blob(const void *blob, size_t size);
+
+/**
+ * Constructs the faces of the graph. This modifies the graph, so it should not
+ * be called while other threads are using the graph.
  * @param pg
  */
 void construct_faces(PLANE_GRAPH *pg);
@@ -119,6 +202,13 @@ PG_EDGE *find_edge(PLANE_GRAPH *pg, int from, int to);
 
 void clear_all_edge_labels(PLANE_GRAPH *pg);
 
+/**
+ * Constructs the dual of the graph. The faces of the graph should be 
+ * constructed.
+ * @param pg
+ * @return the dual, or NULL if the faces of the graph have not been constructed
+ *         or insufficient memory was available
+ */
 PLANE_GRAPH *get_dual_graph(PLANE_GRAPH *pg);
 
 /**
@@ -0,0 +1,286 @@
+/*
+ * Main developer: Nico Van Cleemput
+ *
+ * Copyright (C) 2019 Nico Van Cleemput.
+ * Licensed under the GNU GPL, read the file LICENSE.txt for details.
+ */
+
+#include "planegraphs_collection.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+//the index file starts with this string (padded to 24 bytes), followed by
+//the size of the planar code file, the number of graphs and the offsets
+#define INDEX_HEADER ">>planar_code_index<<"
+#define INDEX_HEADER_SIZE 24
+
+/**
+ * Maps the given file into memory.
+ * @param filename
+ * @param map the start of the mapped file is stored here (NULL for an empty file)
+ * @param size the size of the file is stored here
+ * @return FALSE if the file could not be mapped
+ */
+static boolean map_file(const char *filename, void **map, size_t *size){
+    struct stat file_info;
+    
+    int fd = open(filename, O_RDONLY);
+    if(fd < 0){
+        fprintf(stderr, "Could not open %s.\n", filename);
+        return FALSE;
+    }
+    
+    if(fstat(fd, &file_info) != 0){
+        fprintf(stderr, "Could not determine the size of %s.\n", filename);
+        close(fd);
+        return FALSE;
+    }
+    
+    *map = NULL;
+    *size = (size_t) file_info.st_size;
+    if(*size == 0){
+        close(fd);
+        return TRUE;
+    }
+    
+    *map = mmap(NULL, *size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    
+    if(*map == MAP_FAILED){
+        fprintf(stderr, "Could not map %s into memory.\n", filename);
+        *map = NULL;
+        return FALSE;
+    }
+    
+    return TRUE;
+}
+
+/**
+ * Returns the position directly after the header that starts at position,
+ * or 0 if the header is not closed by <<.
+ */
+static size_t skip_header(const unsigned char *data, size_t size, size_t position){
+    const unsigned char *close = memchr(data + position, '<', size - position);
+    if(close == NULL || close + 1 >= data + size || close[1] != '<'){
+        return 0;
+    }
+    return close - data + 2;
+}
+
+static PG_COLLECTION *map_planar_code_collection(const char *filename, PG_INPUT_OPTIONS *options){
+    PG_COLLECTION *collection = (PG_COLLECTION *)malloc(sizeof(PG_COLLECTION));
+    
+    if(collection == NULL){
+        fprintf(stderr, "Insufficient memory for collection.\n");
+        return NULL;
+    }
+    
+    void *data;
+    if(!map_file(filename, &data, &(collection->size))){
+        free(collection);
+        return NULL;
+    }
+    
+    collection->data = data;
+    collection->options = *options;
+    collection->offsets = NULL;
+    collection->graph_count = 0;
+    collection->index_map = NULL;
+    collection->index_map_size = 0;
+    
+    return collection;
+}
+
+static boolean build_collection_index(PG_COLLECTION *collection){
+    const unsigned char *data = collection->data;
+    size_t size = collection->size;
+    size_t position = 0;
+    size_t allocated = 1024;
+    
+    collection->offsets = (uint64_t *)malloc(sizeof(uint64_t) * allocated);
+    if(collection->offsets == NULL){
+        fprintf(stderr, "Insufficient memory for collection index.\n");
+        return FALSE;
+    }
+    
+    if(collection->options.contains_header){
+        if(size < 13 || memcmp(data, ">>planar_code", 13) != 0){
+            fprintf(stderr, "No planarcode header detected.\n");
+            return FALSE;
+        }
+        position = skip_header(data, size, 13);
+        if(position == 0){
+            fprintf(stderr, "Invalid formatted header.\n");
+            return FALSE;
+        }
+    }
+    
+    while(position < size){
+        /* possibly removing interior headers */
+        if(collection->options.remove_internal_headers && data[position] == '>' &&
+                position + 2 < size && data[position + 1] == '>' && data[position + 2] == 'p'){
+            position = skip_header(data, size, position + 3);
+            if(position == 0){
+                fprintf(stderr, "Problems with header -- single '<'\n");
+                return FALSE;
+            }
+            continue;
+        }
+        
+        size_t length = planar_code_length(data + position, size - position);
+        if(length == 0){
+            fprintf(stderr, "Unexpected EOF.\n");
+            return FALSE;
+        }
+        
+        //keep room for the end offset of the last graph
+        if(collection->graph_count + 1 == allocated){
+            allocated *= 2;
+            uint64_t *new_offsets = (uint64_t *)realloc(collection->offsets, sizeof(uint64_t) * allocated);
+            if(new_offsets == NULL){
+                fprintf(stderr, "Insufficient memory for collection index.\n");
+                return FALSE;
+            }
+            collection->offsets = new_offsets;
+        }
+        
+        collection->offsets[collection->graph_count++] = position;
+        position += length;
+    }
+    
+    collection->offsets[collection->graph_count] = position;
+    
+    return TRUE;
+}
+
+PG_COLLECTION *open_planar_code_collection(const char *filename, PG_INPUT_OPTIONS *options){
+    PG_COLLECTION *collection = map_planar_code_collection(filename, options);
+    
+    if(collection == NULL){
+        return NULL;
+    }
+    
+    if(!build_collection_index(collection)){
+        close_planar_code_collection(collection);
+        return NULL;
+    }
+    
+    return collection;
+}
+
+PG_COLLECTION *open_planar_code_collection_with_index(const char *filename, const char *index_filename,
+                                                     PG_INPUT_OPTIONS *options){
+    uint64_t header[2];
+    size_t i;
+    
+    PG_COLLECTION *collection = map_planar_code_collection(filename, options);
+    
+    if(collection == NULL){
+        return NULL;
+    }
+    
+    if(!map_file(index_filename, &(collection->index_map), &(collection->index_map_size)) ||
+            collection->index_map == NULL){
+        close_planar_code_collection(collection);
+        return NULL;
+    }
+    
+    if(collection->index_map_size < INDEX_HEADER_SIZE + sizeof(header) ||
+            memcmp(collection->index_map, INDEX_HEADER, sizeof(INDEX_HEADER)) != 0){
+        fprintf(stderr, "No planar code index header detected.\n");
+        close_planar_code_collection(collection);
+        return NULL;
+    }
+    
+    memcpy(header, (unsigned char *)collection->index_map + INDEX_HEADER_SIZE, sizeof(header));
+    
+    if(header[0] != collection->size || header[1] >= collection->index_map_size ||
+            collection->index_map_size != INDEX_HEADER_SIZE + sizeof(header) + sizeof(uint64_t) * (header[1] + 1)){
+        fprintf(stderr, "Index does not belong to %s.\n", filename);
+        close_planar_code_collection(collection);
+        return NULL;
+    }
+    
+    collection->graph_count = header[1];
+    collection->offsets = (uint64_t *)((unsigned char *)collection->index_map + INDEX_HEADER_SIZE + sizeof(header));
+    
+    //a stale or damaged index could point outside of the file
+    for(i = 0; i < collection->graph_count; i++){
+        if(collection->offsets[i] > collection->offsets[i + 1]){
+            break;
+        }
+    }
+    if(i < collection->graph_count || collection->offsets[collection->graph_count] > collection->size){
+        fprintf(stderr, "Index of %s contains invalid offsets.\n", filename);
+        close_planar_code_collection(collection);
+        return NULL;
+    }
+    
+    return collection;
+}
+
+boolean save_planar_code_collection_index(PG_COLLECTION *collection, const char *index_filename){
+    char magic[INDEX_HEADER_SIZE] = INDEX_HEADER;
+    uint64_t header[2];
+    
+    FILE *f = fopen(index_filename, "wb");
+    if(f == NULL){
+        fprintf(stderr, "Could not open %s.\n", index_filename);
+        return FALSE;
+    }
+    
+    header[0] = collection->size;
+    header[1] = collection->graph_count;
+    
+    if(fwrite(magic, sizeof(char), INDEX_HEADER_SIZE, f) != INDEX_HEADER_SIZE ||
+            fwrite(header, sizeof(uint64_t), 2, f) != 2 ||
+            fwrite(collection->offsets, sizeof(uint64_t), collection->graph_count + 1, f) != collection->graph_count + 1){
+        fprintf(stderr, "fwrite() failed.\n");
+        fclose(f);
+        return FALSE;
+    }
+    
+    return fclose(f) == 0;
+}
+
+void close_planar_code_collection(PG_COLLECTION *collection){
+    if(collection->index_map != NULL){
+        munmap(collection->index_map, collection->index_map_size);
+    } else if(collection->offsets != NULL){
+        free(collection->offsets);
+    }
+    
+    if(collection->data != NULL){
+        munmap((void *)collection->data, collection->size);
+    }
+    
+    free(collection);
+}
+
+const unsigned char *get_planar_code_from_collection(PG_COLLECTION *collection, size_t number, size_t *length){
+    if(number >= collection->graph_count){
+        return NULL;
+    }
+    
+    if(length != NULL){
+        *length = collection->offsets[number + 1] - collection->offsets[number];
+    }
+    
+    return collection->data + collection->offsets[number];
+}
+
+PLANE_GRAPH *get_graph_from_collection(PG_COLLECTION *collection, size_t number){
+    size_t length;
+    const unsigned char *code = get_planar_code_from_collection(collection, number, &length);
+    
+    if(code == NULL){
+        return NULL;
+    }
+    
+    return decode_planar_code_bytes(code, length, NULL, &(collection->options));
+}
@@ -0,0 +1,102 @@
+/*
+ * Main developer: Nico Van Cleemput
+ *
+ * Copyright (C) 2019 Nico Van Cleemput.
+ * Licensed under the GNU GPL, read the file LICENSE.txt for details.
+ */
+
+#ifndef PLANEGRAPH_COLLECTION_H
+#define PLANEGRAPH_COLLECTION_H
+
+#include "planegraphs_base.h"
+#include "planegraphs_input.h"
+#include <stdint.h>
+
+#ifdef	__cplusplus
+extern "C" {
+#endif
+
+    typedef struct __planar_code_collection PG_COLLECTION;
+    
+    /* A collection gives random access to the graphs in a planar code file.
+     * The file is mapped into memory and an index stores the offset at which 
+     * each graph starts. Graphs are decoded directly from the mapped file.
+     */
+    struct __planar_code_collection {
+        const unsigned char *data;
+        size_t size;
+        
+        //offsets[i] is the offset of graph i in the file, offsets[graph_count] is the end of the last graph
+        uint64_t *offsets;
+        size_t graph_count;
+        
+        PG_INPUT_OPTIONS options;
+        
+        //the memory map of the index if it was loaded from a file, and NULL otherwise
+        void *index_map;
+        size_t index_map_size;
+    };
+
+    /**
+     * Maps the given planar code file into memory and builds the index of
+     * the starting offsets of all graphs in the file.
+     * 
+     * This function returns a NULL pointer if the file could not be mapped or
+     * does not contain valid planar code.
+     * 
+     * @param filename
+     * @param options
+     */
+    PG_COLLECTION *open_planar_code_collection(const char *filename, PG_INPUT_OPTIONS *options);
+    
+    /**
+     * Maps the given planar code file into memory and uses the index that was
+     * previously stored in index_filename by save_planar_code_collection_index.
+     * The index file is also mapped into memory, and is only read once to check
+     * that all offsets lie within the file.
+     * 
+     * This function returns a NULL pointer if one of the files could not be 
+     * mapped, if the index does not belong to this file, or if its offsets are
+     * not increasing or point beyond the end of the file.
+     * 
+     * @param filename
+     * @param index_filename
+     * @param options
+     */
+    PG_COLLECTION *open_planar_code_collection_with_index(const char *filename, const char *index_filename,
+                                                         PG_INPUT_OPTIONS *options);
+    
+    /**
+     * Stores the index of the collection in a file, so that it can be reused
+     * by open_planar_code_collection_with_index.
+     * @param collection
+     * @param index_filename
+     * @return TRUE if the index was successfully stored
+     */
+    boolean save_planar_code_collection_index(PG_COLLECTION *collection, const char *index_filename);
+    
+    void close_planar_code_collection(PG_COLLECTION *collection);
+    
+    /**
+     * Returns a pointer to the planar code of the given graph inside the mapped
+     * file. 
+     * @param collection
+     * @param number the number of the graph (starting from 0)
+     * @param length if not NULL, the length of the code in bytes is stored here
+     * @return a pointer to the code, or NULL if there is no graph with that number
+     */
+    const unsigned char *get_planar_code_from_collection(PG_COLLECTION *collection, size_t number, size_t *length);
+    
+    /**
+     * Decodes the given graph of the collection.
+     * @param collection
+     * @param number the number of the graph (starting from 0)
+     * @return the decoded graph, or NULL if there is no graph with that number
+     */
+    PLANE_GRAPH *get_graph_from_collection(PG_COLLECTION *collection, size_t number);
+
+#ifdef	__cplusplus
+}
+#endif
+
+#endif //PLANEGRAPH_COLLECTION_H
@@ -0,0 +1,291 @@
+/*
+ * Main developer: Nico Van Cleemput
+ *
+ * Copyright (C) 2019 Nico Van Cleemput.
+ * Licensed under the GNU GPL, read the file LICENSE.txt for details.
+ */
+
+#include "planegraphs_compact.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+/**
+ * Allocates a compact graph with room for exactly maxn vertices and maxe
+ * oriented edges. Unlike new_compact_plane_graph, maxe is not limited to the
+ * number of edges of a simple plane graph, so this can also hold multigraphs
+ * such as duals.
+ */
+static PG_COMPACT_GRAPH *allocate_compact_plane_graph(int maxn, int maxe){
+    PG_COMPACT_GRAPH *cg = (PG_COMPACT_GRAPH *)malloc(sizeof(PG_COMPACT_GRAPH));
+    
+    if(cg == NULL){
+        fprintf(stderr, "Insufficient memory for compact plane graph -- exiting!\n");
+        return NULL;
+    }
+    
+    cg->maxn = maxn;
+    cg->maxe = maxe;
+    
+    cg->nv = cg->ne = cg->nf = 0;
+    
+    cg->edges = (PG_COMPACT_EDGE *)malloc(sizeof(PG_COMPACT_EDGE)*maxe);
+    cg->right_face = (uint32_t *)malloc(sizeof(uint32_t)*maxe);
+    cg->colour = (int *)malloc(sizeof(int)*maxe);
+    cg->mark = (int *)calloc(maxe, sizeof(int));
+    cg->label = (void **)calloc(maxe, sizeof(void *));
+    cg->first_edge = (uint32_t *)malloc(sizeof(uint32_t)*maxn);
+    cg->degree = (int *)malloc(sizeof(int)*maxn);
+    
+    //by default the dual is not yet initialised
+    cg->maxf = 0;
+    cg->face_start = NULL;
+    cg->face_size = NULL;
+    cg->faces_constructed = FALSE;
+    cg->mark_value = 30000;
+    
+    if(cg->edges == NULL || cg->right_face == NULL || cg->colour == NULL || cg->mark == NULL ||
+            cg->label == NULL || cg->first_edge == NULL || cg->degree == NULL){
+        fprintf(stderr, "Insufficient memory for compact plane graph -- exiting!\n");
+        free_compact_plane_graph(cg);
+        return NULL;
+    }
+    
+    return cg;
+}
+
+PG_COMPACT_GRAPH *new_compact_plane_graph(int maxn, int maxe){
+    if(maxn <= 0){
+        fprintf(stderr, "maxn should be a positive integer -- exiting!\n");
+        return NULL;
+    }
+    
+    if(maxe <= 0 || maxe > (6*maxn-12)){
+        maxe = 6*maxn-12;
+    }
+    
+    return allocate_compact_plane_graph(maxn, maxe);
+}
+
+void free_compact_plane_graph(PG_COMPACT_GRAPH *cg){
+    free(cg->face_start);
+    free(cg->face_size);
+    free(cg->degree);
+    free(cg->first_edge);
+    free(cg->label);
+    free(cg->mark);
+    free(cg->colour);
+    free(cg->right_face);
+    free(cg->edges);
+    free(cg);
+}
+
+/**
+ * Makes sure the face arrays of the compact graph can hold maxf faces.
+ * @return FALSE if insufficient memory was available
+ */
+static boolean allocate_compact_faces(PG_COMPACT_GRAPH *cg, int maxf){
+    if(cg->maxf >= maxf){
+        return TRUE;
+    }
+    
+    free(cg->face_start);
+    free(cg->face_size);
+    cg->face_start = (uint32_t *)malloc(sizeof(uint32_t) * maxf);
+    cg->face_size = (int *)malloc(sizeof(int) * maxf);
+    
+    if(cg->face_start == NULL || cg->face_size == NULL){
+        free(cg->face_start);
+        free(cg->face_size);
+        cg->face_start = NULL;
+        cg->face_size = NULL;
+        cg->maxf = 0;
+        return FALSE;
+    }
+    
+    cg->maxf = maxf;
+    return TRUE;
+}
+
+PG_COMPACT_GRAPH *convert_to_compact_plane_graph(PLANE_GRAPH *pg){
+    int i;
+    
+    //the graph can have more edges than a simple plane graph, e.g., if it is a dual
+    PG_COMPACT_GRAPH *cg = allocate_compact_plane_graph(pg->maxn, pg->maxe);
+    
+    if(cg == NULL){
+        return NULL;
+    }
+    
+    cg->nv = pg->nv;
+    cg->ne = pg->ne;
+    
+    for(i = 0; i < pg->ne; i++){
+        PG_EDGE *e = pg->edges + i;
+        cg->edges[i].next = e->next - pg->edges;
+        cg->edges[i].prev = e->prev - pg->edges;
+        cg->edges[i].inverse = e->inverse - pg->edges;
+        cg->edges[i].end = e->end;
+        cg->colour[i] = e->colour;
+        cg->label[i] = e->label;
+    }
+    
+    for(i = 0; i < pg->nv; i++){
+        cg->first_edge[i] = pg->first_edge[i] - pg->edges;
+        cg->degree[i] = pg->degree[i];
+    }
+    
+    if(pg->faces_constructed){
+        if(!allocate_compact_faces(cg, pg->nf)){
+            free_compact_plane_graph(cg);
+            return NULL;
+        }
+        cg->nf = pg->nf;
+        for(i = 0; i < pg->ne; i++){
+            cg->right_face[i] = pg->edges[i].right_face;
+        }
+        for(i = 0; i < pg->nf; i++){
+            cg->face_start[i] = pg->face_start[i] - pg->edges;
+            cg->face_size[i] = pg->face_size[i];
+        }
+        cg->faces_constructed = TRUE;
+    }
+    
+    return cg;
+}
+
+PLANE_GRAPH *convert_from_compact_plane_graph(PG_COMPACT_GRAPH *cg){
+    int i;
+    
+    PLANE_GRAPH *pg = new_plane_graph(cg->maxn, cg->maxe);
+    
+    if(pg == NULL){
+        return NULL;
+    }
+    
+    pg->nv = cg->nv;
+    pg->ne = cg->ne;
+    
+    for(i = 0; i < cg->ne; i++){
+        PG_EDGE *e = pg->edges + i;
+        e->start = COMPACT_START(cg, i);
+        e->end = cg->edges[i].end;
+        e->next = pg->edges + cg->edges[i].next;
+        e->prev = pg->edges + cg->edges[i].prev;
+        e->inverse = pg->edges + cg->edges[i].inverse;
+        e->colour = cg->colour[i];
+        e->label = cg->label[i];
+    }
+    
+    for(i = 0; i < cg->nv; i++){
+        pg->first_edge[i] = pg->edges + cg->first_edge[i];
+        pg->degree[i] = cg->degree[i];
+    }
+    
+    if(cg->faces_constructed){
+        //the arrays for the faces are allocated together with the edges
+        if(cg->nf > pg->maxf){
+            fprintf(stderr, "Too many faces for plane_graph.\n");
+            free_plane_graph(pg);
+            return NULL;
+        }
+        pg->nf = cg->nf;
+        for(i = 0; i < cg->ne; i++){
+            pg->edges[i].right_face = cg->right_face[i];
+        }
+        for(i = 0; i < cg->nf; i++){
+            pg->face_start[i] = pg->edges + cg->face_start[i];
+            pg->face_size[i] = cg->face_size[i];
+        }
+        pg->faces_constructed = TRUE;
+    }
+    
+    return pg;
+}
+
+/* Store in right_face[e] the number of the face on the right hand side of 
+   edge e.  Faces are numbered 0,1,....  Also store in face_start[i] an 
+   example of an edge in the clockwise orientation of the face boundary, and 
+   the size of the face in face_size[i], for each i. No marks are needed, 
+   since right_face is used to see which edges have already been handled. */
+void construct_faces_compact(PG_COMPACT_GRAPH *cg) {
+    int i, sz;
+    uint32_t e, ex, ef;
+    const PG_COMPACT_EDGE *edges = cg->edges;
+    
+    //first allocate the memory to store faces if this has not yet been done
+    if(!allocate_compact_faces(cg, 2*cg->maxn - 4 > cg->ne ? 2*cg->maxn - 4 : cg->ne)){
+        return;
+    }
+    
+    for(i = 0; i < cg->ne; i++){
+        cg->right_face[i] = UINT32_MAX;
+    }
+
+    int nf = 0;
+    for (i = 0; i < cg->nv; ++i) {
+        e = ex = cg->first_edge[i];
+        do {
+            if (cg->right_face[e] == UINT32_MAX) {
+                cg->face_start[nf] = ef = e;
+                sz = 0;
+                do {
+                    cg->right_face[ef] = nf;
+                    ef = edges[edges[ef].inverse].prev;
+                    ++sz;
+                } while (ef != e);
+                cg->face_size[nf] = sz;
+                ++nf;
+            }
+            e = edges[e].next;
+        } while (e != ex);
+    }
+    cg->nf = nf;
+    cg->faces_constructed = TRUE;
+}
+
+PG_COMPACT_GRAPH *get_dual_compact_graph(PG_COMPACT_GRAPH *cg){
+    int i;
+    
+    if(!cg->faces_constructed){
+        construct_faces_compact(cg);
+    }
+    
+    //the dual has exactly as many edges as the graph, even if the dual has
+    //more edges than a simple plane graph with that number of vertices
+    PG_COMPACT_GRAPH *dual = allocate_compact_plane_graph(cg->nf, cg->ne);
+    
+    if(dual == NULL || !allocate_compact_faces(dual, cg->nv)){
+        fprintf(stderr, "Insufficient memory to create dual.\n");
+        if(dual != NULL){
+            free_compact_plane_graph(dual);
+        }
+        return NULL;
+    }
+    
+    dual->nv = cg->nf;
+    dual->ne = cg->ne;
+    dual->nf = cg->nv;
+    
+    for(i = 0; i < cg->ne; i++){
+        const PG_COMPACT_EDGE *e = cg->edges + i;
+        dual->edges[i].end = cg->right_face[e->inverse];
+        dual->right_face[i] = cg->edges[i].end;
+        dual->edges[i].inverse = e->inverse;
+        dual->edges[i].next = cg->edges[e->inverse].prev;
+        dual->edges[i].prev = cg->edges[e->next].inverse;
+    }
+    
+    for(i = 0; i < cg->nf; i++){
+        dual->degree[i] = cg->face_size[i];
+        dual->first_edge[i] = cg->face_start[i];
+    }
+    
+    for(i = 0; i < cg->nv; i++){
+        dual->face_size[i] = cg->degree[i];
+        dual->face_start[i] = cg->edges[cg->first_edge[i]].inverse;
+    }
+    
+    dual->faces_constructed = TRUE;
+    
+    return dual;
+}
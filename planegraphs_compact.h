@@ -0,0 +1,131 @@
+/*
+ * Main developer: Nico Van Cleemput
+ *
+ * Copyright (C) 2019 Nico Van Cleemput.
+ * Licensed under the GNU GPL, read the file LICENSE.txt for details.
+ */
+
+#ifndef PLANEGRAPH_COMPACT_H
+#define PLANEGRAPH_COMPACT_H
+
+#include "planegraphs_base.h"
+#include <stdint.h>
+
+typedef struct __pg_compact_edge PG_COMPACT_EDGE;
+typedef struct __compact_plane_graph PG_COMPACT_GRAPH;
+
+/* The data that is needed to traverse a compact plane graph. Edges are
+ * referred to by their index in the edges array of the compact graph.
+ */
+struct __pg_compact_edge {
+    uint32_t next; /* next edge in clockwise direction */
+    uint32_t prev; /* previous edge in clockwise direction */
+    uint32_t inverse; /* the edge that is inverse to this one */
+    uint32_t end;
+};
+
+/* A more compact representation of a plane graph: edges are stored as 32-bit
+ * indices instead of pointers, and the data that is needed for traversals is 
+ * kept apart from the data that is only used occasionally. This uses less
+ * than half of the memory of a PLANE_GRAPH for each edge.
+ */
+struct __compact_plane_graph {
+    int nv;
+    int ne;
+    int nf;
+    
+    int maxn;
+    int maxe;
+    int maxf;
+    
+    //an array containing all edges of this graph
+    PG_COMPACT_EDGE *edges;
+    
+    //an array containing for each edge the face on the right side of the edge
+    //NOTE: only valid if construct_faces_compact called on the graph
+    uint32_t *right_face;
+    
+    //arrays containing for each edge the colour, mark and label
+    int *colour;
+    int *mark;
+    void **label;
+    
+    //an array containing for each vertex an edge leaving that vertex
+    uint32_t *first_edge;
+    
+    //an array containing the degree of each vertex
+    int *degree;
+    
+    //an array containing for each face an edge in the clockwise 
+    //boundary of that face
+    uint32_t *face_start;
+    
+    //an array containing the size of each face
+    int *face_size;
+    
+    //TRUE if the faces of this graph have been constructed
+    boolean faces_constructed;
+    
+    //should be set to 30000 for a new graph
+    int mark_value;
+};
+
+#define COMPACT_START(cg, e) ((cg)->edges[(cg)->edges[e].inverse].end)
+
+#define COMPACT_RESETMARKS(cg) {int mki; if (((cg)->mark_value += 2) > 30000) \
+       { (cg)->mark_value = 2; for (mki=0;mki<(cg)->maxe;++mki) (cg)->mark[mki]=0; \
+         PG_STATS_ADD(PG_STATS_MARK_WRAPS, 1);}}
+#define COMPACT_MARK(cg, e) (cg)->mark[e] = (cg)->mark_value
+#define COMPACT_UNMARK(cg, e) (cg)->mark[e] = (cg)->mark_value-1
+#define COMPACT_ISMARKED(cg, e) ((cg)->mark[e] >= (cg)->mark_value)
+
+/**
+ * Creates a new compact plane graph data structure that can hold plane graphs
+ * with up to maxn vertices and maxe oriented edges. If maxe is zero, then the 
+ * theoretical maximum for maxn is computed and used.
+ * 
+ * This function might return a NULL pointer if insufficient memory was
+ * available or the number of vertices is illegal.
+ *
+ * @param maxn the maximum number of vertices this plane graph will contain
+ * @param maxe the maximum number of oriented edges this plane graph will contain,
+ *             or zero if the theoretical maximum should be used
+ */
+PG_COMPACT_GRAPH *new_compact_plane_graph(int maxn, int maxe);
+
+void free_compact_plane_graph(PG_COMPACT_GRAPH *cg);
+
+/**
+ * Converts a plane graph to a compact plane graph. Edge i of the compact graph
+ * corresponds to edge i of the plane graph, and the faces are copied if they
+ * have been constructed.
+ * @param pg
+ * @return the compact graph, or NULL if insufficient memory was available
+ */
+PG_COMPACT_GRAPH *convert_to_compact_plane_graph(PLANE_GRAPH *pg);
+
+/**
+ * Converts a compact plane graph to a plane graph. Edge i of the plane graph
+ * corresponds to edge i of the compact graph, and the faces are copied if they
+ * have been constructed.
+ * @param cg
+ * @return the plane graph, or NULL if insufficient memory was available
+ */
+PLANE_GRAPH *convert_from_compact_plane_graph(PG_COMPACT_GRAPH *cg);
+
+/**
+ * Constructs the faces of the compact graph. The faces are numbered in the
+ * same way as construct_faces numbers the faces of a plane graph.
+ * @param cg
+ */
+void construct_faces_compact(PG_COMPACT_GRAPH *cg);
+
+/**
+ * Returns the dual of the compact graph. Edge i of the dual crosses edge i of
+ * the graph.
+ * @param cg
+ * @return the dual graph, or NULL if insufficient memory was available
+ */
+PG_COMPACT_GRAPH *get_dual_compact_graph(PG_COMPACT_GRAPH *cg);
+
+#endif //PLANEGRAPH_COMPACT_H
@@ -5,20 +5,1074 @@
  * Licensed under the GNU GPL, read the file LICENSE.txt for details.
  */
 
+#include <stdio.h>
+#include <stdlib.h>
 #include "planegraphs_base.h"
 #include "planegraphs_cycles.h"
 #include "planegraphs_connectivity.h"
 
+/* A minimal edge-cut of a connected plane graph corresponds to a cycle in the
+ * dual graph. Instead of constructing the dual, the functions below walk the
+ * faces of the graph: the neighbours of face f in the dual are the faces 
+ * e->inverse->right_face for the edges e on the boundary of f.
+ */
+
+/* The scratch space for finding small edge-cuts. */
+typedef struct __pg_edge_cut_data {
+    //the faces sorted by decreasing size, and the position of each face in that order
+    int *order;
+    int *rank;
+    
+    //for each face the last face (plus one) for which it was marked
+    int *mark;
+    //for each face the edges through which it was marked
+    PG_EDGE **via;
+    PG_EDGE **second_via;
+    
+    //the breadth-first searches for larger cuts: these are only allocated
+    //when they are needed
+    int *distance;
+    int *queue;
+} PG_EDGE_CUT_DATA;
+
+static void store_cut(PG_EDGE **cut, int *cut_size, PG_EDGE **edges, int size){
+    if(cut != NULL){
+        for(int i = 0; i < size; i++){
+            cut[i] = edges[i];
+        }
+    }
+    if(cut_size != NULL){
+        *cut_size = size;
+    }
+}
+
+/**
+ * Looks for a bridge, i.e., an edge that has the same face on both sides, or 
+ * for an edge-cut of size 2, i.e., two faces that share two edges.
+ * @param maximum only cuts smaller than this are searched
+ * @return the size of the cut that was found, or 0 if no cut was found
+ */
+static int find_edge_cut_of_size_at_most_two(PLANE_GRAPH *graph, int maximum, PG_EDGE_CUT_DATA *data,
+                                             PG_EDGE **cut, int *cut_size){
+    for(int i = 0; i < graph->ne; i++){
+        PG_EDGE *e = graph->edges + i;
+        if(e->right_face == e->inverse->right_face){
+            store_cut(cut, cut_size, &e, 1);
+            return 1;
+        }
+    }
+    if(maximum <= 2){
+        return 0;
+    }
+    for(int f = 0; f < graph->nf; f++){
+        PG_EDGE *e = graph->face_start[f];
+        for(int j = 0; j < graph->face_size[f]; j++){
+            int neighbour = e->inverse->right_face;
+            if(data->mark[neighbour] == f + 1){
+                PG_EDGE *edges[2] = {data->via[neighbour], e};
+                store_cut(cut, cut_size, edges, 2);
+                return 2;
+            }
+            data->mark[neighbour] = f + 1;
+            data->via[neighbour] = e;
+            e = e->inverse->prev;
+        }
+    }
+    return 0;
+}
+
+/**
+ * Sorts the faces by decreasing size using counting sort. The graph should not
+ * have cuts of size at most 2, so that no face size exceeds nf-1.
+ */
+static void order_faces_by_decreasing_size(PLANE_GRAPH *graph, PG_EDGE_CUT_DATA *data){
+    int max_size = 0;
+    for(int f = 0; f < graph->nf; f++){
+        if(graph->face_size[f] > max_size){
+            max_size = graph->face_size[f];
+        }
+    }
+    //use mark to count the faces of each size
+    int *count = data->mark;
+    for(int s = 0; s <= max_size; s++){
+        count[s] = 0;
+    }
+    for(int f = 0; f < graph->nf; f++){
+        count[max_size - graph->face_size[f]]++;
+    }
+    int position = 0;
+    for(int s = 0; s <= max_size; s++){
+        int faces_of_size = count[s];
+        count[s] = position;
+        position += faces_of_size;
+    }
+    for(int f = 0; f < graph->nf; f++){
+        int i = count[max_size - graph->face_size[f]]++;
+        data->order[i] = f;
+        data->rank[f] = i;
+    }
+}
+
+/* As for the girth, cuts of size 3 and 4 are triangles and quadrangles in the
+ * dual, which are found by handling the faces by decreasing size and only 
+ * looking at faces that have not yet been handled (Chiba and Nishizeki).
+ */
+
+/**
+ * Looks for an edge-cut of size 3 in a graph without cuts of size at most 2.
+ * @return TRUE if a cut was found
+ */
+static boolean find_edge_cut_of_size_three(PLANE_GRAPH *graph, PG_EDGE_CUT_DATA *data,
+                                           PG_EDGE **cut, int *cut_size){
+    for(int f = 0; f < graph->nf; f++){
+        data->mark[f] = 0;
+    }
+    for(int i = 0; i < graph->nf; i++){
+        int f = data->order[i];
+        PG_EDGE *e = graph->face_start[f];
+        for(int j = 0; j < graph->face_size[f]; j++){
+            data->mark[e->inverse->right_face] = f + 1;
+            data->via[e->inverse->right_face] = e;
+            e = e->inverse->prev;
+        }
+        
+        for(int j = 0; j < graph->face_size[f]; j++){
+            int g = e->inverse->right_face;
+            if(data->rank[g] > i){
+                PG_EDGE *e2 = e->inverse;
+                for(int l = 0; l < graph->face_size[g]; l++){
+                    int h = e2->inverse->right_face;
+                    if(data->rank[h] > i && data->mark[h] == f + 1){
+                        PG_EDGE *edges[3] = {e, e2, data->via[h]};
+                        store_cut(cut, cut_size, edges, 3);
+                        return TRUE;
+                    }
+                    e2 = e2->inverse->prev;
+                }
+            }
+            e = e->inverse->prev;
+        }
+    }
+    return FALSE;
+}
+
+/**
+ * Looks for an edge-cut of size 4 in a graph without cuts of size at most 3:
+ * such a cut exists if a face f has two paths of length 2 to the same face in
+ * the dual.
+ * @return TRUE if a cut was found
+ */
+static boolean find_edge_cut_of_size_four(PLANE_GRAPH *graph, PG_EDGE_CUT_DATA *data,
+                                          PG_EDGE **cut, int *cut_size){
+    for(int f = 0; f < graph->nf; f++){
+        data->mark[f] = 0;
+    }
+    for(int i = 0; i < graph->nf; i++){
+        int f = data->order[i];
+        PG_EDGE *e = graph->face_start[f];
+        for(int j = 0; j < graph->face_size[f]; j++){
+            int g = e->inverse->right_face;
+            if(data->rank[g] > i){
+                PG_EDGE *e2 = e->inverse;
+                for(int l = 0; l < graph->face_size[g]; l++){
+                    int h = e2->inverse->right_face;
+                    if(h != f && data->rank[h] > i){
+                        if(data->mark[h] == f + 1){
+                            PG_EDGE *edges[4] = {data->via[h], data->second_via[h], e2, e};
+                            store_cut(cut, cut_size, edges, 4);
+                            return TRUE;
+                        }
+                        data->mark[h] = f + 1;
+                        data->via[h] = e;
+                        data->second_via[h] = e2;
+                    }
+                    e2 = e2->inverse->prev;
+                }
+            }
+            e = e->inverse->prev;
+        }
+    }
+    return FALSE;
+}
+
+/**
+ * Stores the cut that corresponds to the cycle in the dual that consists of the
+ * edge e from face x to face y and the paths from x and from the given face
+ * (either y or its parent) to their common ancestor in the breadth-first
+ * search tree. The face of the edge via[g] is the parent of face g.
+ * @return the size of the cut
+ */
+static int store_cut_in_search_tree(PG_EDGE *e, int y_side_start, PG_EDGE_CUT_DATA *data,
+                                    PG_EDGE **cut, int *cut_size){
+    int size = 0;
+    int x = e->right_face;
+    int y = e->inverse->right_face;
+    if(cut != NULL){
+        cut[size] = e;
+        if(y_side_start != y){
+            cut[size + 1] = data->via[y];
+        }
+    }
+    size += (y_side_start == y) ? 1 : 2;
+    //both sides are at the same depth, so they reach the common ancestor at the same time
+    int f = x, g = y_side_start;
+    while(f != g){
+        if(cut != NULL){
+            cut[size] = data->via[f];
+            cut[size + 1] = data->via[g];
+        }
+        size += 2;
+        f = data->via[f]->right_face;
+        g = data->via[g]->right_face;
+    }
+    if(cut_size != NULL){
+        *cut_size = size;
+    }
+    return size;
+}
+
+/**
+ * Looks for a smallest edge-cut smaller than maximum in a graph without cuts of
+ * size at most 4, which is only possible if the graph has parallel edges. Such
+ * a cut is a cycle in the dual, which is found by breadth-first searches of 
+ * depth at most (maximum-1)/2 from each face. As for the girth, the faces are
+ * handled by decreasing size and each search only visits the faces that have
+ * not yet been handled.
+ * @return the size of the cut that was found, or 0 if no cut was found
+ */
+static int find_edge_cut_by_search(PLANE_GRAPH *graph, int maximum, PG_EDGE_CUT_DATA *data,
+                                   PG_EDGE **cut, int *cut_size){
+    int best = 0;
+    
+    data->distance = (int *)malloc(sizeof(int) * graph->nf);
+    data->queue = (int *)malloc(sizeof(int) * graph->nf);
+    if(data->distance == NULL || data->queue == NULL){
+        fprintf(stderr, "Insufficient memory for edge connectivity -- exiting!\n");
+        exit(EXIT_FAILURE);
+    }
+    for(int f = 0; f < graph->nf; f++){
+        data->distance[f] = -1;
+    }
+    
+    for(int i = 0; i < graph->nf; i++){
+        int head = 0, tail = 0;
+        int root = data->order[i];
+        data->queue[head++] = root;
+        data->distance[root] = 0;
+        data->via[root] = NULL;
+        while(tail < head){
+            int f = data->queue[tail++];
+            int current_distance = data->distance[f];
+            if(2*current_distance + 1 >= maximum){
+                //even the smallest cut through this level is too large
+                break;
+            }
+            PG_EDGE *e = graph->face_start[f];
+            for(int j = 0; j < graph->face_size[f]; j++, e = e->inverse->prev){
+                int g = e->inverse->right_face;
+                int neighbour_distance = data->distance[g];
+                if(data->rank[g] < i || (data->via[f] != NULL && e->inverse == data->via[f])){
+                    //g has already been handled, or this is the edge to the parent of f
+                } else if(neighbour_distance < 0){
+                    data->distance[g] = current_distance + 1;
+                    data->via[g] = e;
+                    data->queue[head++] = g;
+                } else if(neighbour_distance == current_distance){
+                    maximum = best = store_cut_in_search_tree(e, g, data, cut, cut_size);
+                } else if(neighbour_distance > current_distance && 2*current_distance + 2 < maximum){
+                    maximum = best = store_cut_in_search_tree(e, data->via[g]->right_face, data, cut, cut_size);
+                }
+            }
+        }
+        
+        //only reset the faces that were reached
+        for(int j = 0; j < head; j++){
+            data->distance[data->queue[j]] = -1;
+        }
+    }
+    
+    free(data->distance);
+    free(data->queue);
+    
+    return best;
+}
+
+/**
+ * Looks for an edge-cut smaller than maximum. The cuts are searched by 
+ * increasing size, so the cut that is found is a smallest cut. Cuts with at
+ * most 4 edges are found in linear time. A simple plane graph has at most 3n-6
+ * edges, and thus a vertex of degree at most 5 whose edges form a cut, so larger
+ * cuts are only searched if maximum is larger than 5, which is only possible
+ * if the graph has parallel edges.
+ * @param graph a connected plane graph for which the faces are constructed
+ * @param maximum
+ * @return the size of the cut that was found, or 0 if there is no edge-cut
+ *         smaller than maximum
+ */
+static int find_small_edge_cut(PLANE_GRAPH *graph, int maximum, PG_EDGE **cut, int *cut_size){
+    if(maximum <= 1 || graph->nf == 0){
+        return 0;
+    }
+    
+    PG_EDGE_CUT_DATA data;
+    data.order = (int *)malloc(sizeof(int) * graph->nf);
+    data.rank = (int *)malloc(sizeof(int) * graph->nf);
+    data.mark = (int *)calloc(graph->nf, sizeof(int));
+    data.via = (PG_EDGE **)malloc(sizeof(PG_EDGE *) * graph->nf);
+    data.second_via = (PG_EDGE **)malloc(sizeof(PG_EDGE *) * graph->nf);
+    if(data.order == NULL || data.rank == NULL || data.mark == NULL || data.via == NULL ||
+            data.second_via == NULL){
+        fprintf(stderr, "Insufficient memory for edge connectivity -- exiting!\n");
+        exit(EXIT_FAILURE);
+    }
+    
+    int size = find_edge_cut_of_size_at_most_two(graph, maximum, &data, cut, cut_size);
+    if(!size && maximum > 3){
+        order_faces_by_decreasing_size(graph, &data);
+        if(find_edge_cut_of_size_three(graph, &data, cut, cut_size)){
+            size = 3;
+        } else if(maximum > 4 && find_edge_cut_of_size_four(graph, &data, cut, cut_size)){
+            size = 4;
+        } else if(maximum > 5){
+            size = find_edge_cut_by_search(graph, maximum, &data, cut, cut_size);
+        }
+    }
+    
+    free(data.order);
+    free(data.rank);
+    free(data.mark);
+    free(data.via);
+    free(data.second_via);
+    
+    return size;
+}
+
+/**
+ * Stores the edges leaving a vertex of minimum degree as a cut.
+ * @return the minimum degree
+ */
+static int store_smallest_vertex_cut(PLANE_GRAPH *graph, PG_EDGE **cut, int *cut_size){
+    int v = 0;
+    for(int i = 1; i < graph->nv; i++){
+        if(graph->degree[i] < graph->degree[v]){
+            v = i;
+        }
+    }
+    if(cut != NULL){
+        PG_EDGE *e = graph->first_edge[v];
+        for(int i = 0; i < graph->degree[v]; i++){
+            cut[i] = e;
+            e = e->next;
+        }
+    }
+    if(cut_size != NULL){
+        *cut_size = graph->degree[v];
+    }
+    return graph->degree[v];
+}
+
+boolean is_k_edge_connected(PLANE_GRAPH *graph, int k, PG_EDGE **cut, int *cut_size){
+    if(!graph->faces_constructed){
+        fprintf(stderr, "The faces of the graph have not been constructed -- exiting!\n");
+        exit(EXIT_FAILURE);
+    }
+    if(minimum_degree(graph) < k){
+        store_smallest_vertex_cut(graph, cut, cut_size);
+        return FALSE;
+    }
+    return !find_small_edge_cut(graph, k, cut, cut_size);
+}
+
+int edge_connectivity_with_cut(PLANE_GRAPH *graph, PG_EDGE **cut){
+    if(!graph->faces_constructed){
+        return -1;
+    }
+    int size;
+    if(find_small_edge_cut(graph, minimum_degree(graph), cut, &size)){
+        return size;
+    }
+    return store_smallest_vertex_cut(graph, cut, NULL);
+}
+
+/**
+ * Performs an iterative depth-first search to determine whether the graph is
+ * connected and to find a cut vertex.
+ * @param graph
+ * @param cut_vertex will contain a cut vertex, or -1 if the graph has no cut vertex
+ * @return TRUE if the graph is connected, and FALSE otherwise
+ */
+static boolean find_cut_vertex(PLANE_GRAPH *graph, int *cut_vertex){
+    int *discovery = (int *)calloc(graph->nv, sizeof(int));
+    int *low = (int *)malloc(sizeof(int) * graph->nv);
+    int *stack = (int *)malloc(sizeof(int) * graph->nv);
+    int *remaining_edges = (int *)malloc(sizeof(int) * graph->nv);
+    PG_EDGE **current_edge = (PG_EDGE **)malloc(sizeof(PG_EDGE *) * graph->nv);
+    PG_EDGE **parent_edge = (PG_EDGE **)malloc(sizeof(PG_EDGE *) * graph->nv);
+    if(discovery == NULL || low == NULL || stack == NULL || remaining_edges == NULL ||
+            current_edge == NULL || parent_edge == NULL){
+        fprintf(stderr, "Insufficient memory for vertex connectivity -- exiting!\n");
+        exit(EXIT_FAILURE);
+    }
+    
+    int time = 0, top = 0, root_children = 0;
+    *cut_vertex = -1;
+    discovery[0] = low[0] = ++time;
+    remaining_edges[0] = graph->degree[0];
+    current_edge[0] = graph->first_edge[0];
+    parent_edge[0] = NULL;
+    stack[top++] = 0;
+    while(top){
+        int v = stack[top - 1];
+        if(remaining_edges[v]){
+            PG_EDGE *e = current_edge[v];
+            current_edge[v] = e->next;
+            remaining_edges[v]--;
+            int w = e->end;
+            if(!discovery[w]){
+                discovery[w] = low[w] = ++time;
+                remaining_edges[w] = graph->degree[w];
+                current_edge[w] = graph->first_edge[w];
+                parent_edge[w] = e;
+                stack[top++] = w;
+                if(v == 0){
+                    root_children++;
+                }
+            } else if(e->inverse != parent_edge[v] && discovery[w] < low[v]){
+                low[v] = discovery[w];
+            }
+        } else {
+            //all edges of v have been handled, so return to its parent
+            top--;
+            if(top){
+                int parent = stack[top - 1];
+                if(low[v] < low[parent]){
+                    low[parent] = low[v];
+                }
+                if(parent != 0 && low[v] >= discovery[parent] && *cut_vertex == -1){
+                    *cut_vertex = parent;
+                }
+            }
+        }
+    }
+    if(root_children > 1 && *cut_vertex == -1){
+        *cut_vertex = 0;
+    }
+    
+    free(discovery);
+    free(low);
+    free(stack);
+    free(remaining_edges);
+    free(current_edge);
+    free(parent_edge);
+    
+    return time == graph->nv;
+}
+
+/* In a 2-connected plane graph a minimal vertex separator of size k corresponds
+ * to a cycle of length 2k in the vertex-face incidence graph that has vertices
+ * of the graph on both sides. The elements of the incidence graph are the 
+ * vertices (0 to nv-1) and the faces (nv to nv+nf-1) of the graph, and its 
+ * edges are the corners. The corner of vertex v in face f is represented by
+ * the edge e leaving v that has f as right face. The incidence graph is never
+ * constructed: the faces around a vertex and the vertices around a face are
+ * found by walking around the vertex or the face.
+ */
+
+#define MAXIMUM_SEPARATOR_SEARCH 4
+#define STORED_PATHS 3
+
+/* The scratch space for finding small vertex separators. */
+typedef struct __pg_separator_data {
+    //the elements sorted by decreasing degree in the incidence graph, and the 
+    //position of each element in that order
+    int *order;
+    int *rank;
+    
+    //for each element the last stamp with which it was marked
+    int *mark;
+    //for each element marked as a neighbour of the anchor, the corner that connects them
+    PG_EDGE **corner_to_anchor;
+    //the paths of length 2 from the anchor to each element
+    int *stored_path_count;
+    PG_EDGE **stored_paths;
+    //for each element the last stamp with which it was put on the current path
+    int *on_path;
+    int stamp;
+    //for each vertex the last stamp with which it was marked as part of a cycle
+    int *on_cycle;
+    int cycle_stamp;
+    
+    //the corners of the current path
+    PG_EDGE *path[2*MAXIMUM_SEPARATOR_SEARCH];
+} PG_SEPARATOR_DATA;
+
+#define FACE_ELEMENT(graph, f) ((graph)->nv + (f))
+
+/**
+ * Checks the edges that are met when turning clockwise around a vertex of a 
+ * cycle from the corner in to the corner out, i.e., the edges of that vertex on
+ * one side of the cycle.
+ * @return TRUE if all these edges end in vertices of the cycle
+ */
+static boolean sector_only_contains_cycle_vertices(PG_EDGE *in, PG_EDGE *out, PG_SEPARATOR_DATA *data){
+    PG_EDGE *e = in;
+    do {
+        e = e->next;
+        if(data->on_cycle[e->end] != data->cycle_stamp){
+            return FALSE;
+        }
+    } while (e != out);
+    return TRUE;
+}
+
+/**
+ * Checks whether the cycle in the incidence graph given by its corners has
+ * vertices of the graph on both sides. A side contains no vertex if and only if
+ * all edges on that side of the cycle vertices end in vertices of the cycle.
+ * @param corners the corners of the cycle in the order in which they are met
+ * @param length the number of corners
+ * @return TRUE if the vertices of the cycle form a separator
+ */
+static boolean is_separating_cycle(PG_EDGE **corners, int length, PG_SEPARATOR_DATA *data){
+    data->cycle_stamp++;
+    for(int i = 0; i < length; i++){
+        data->on_cycle[corners[i]->start] = data->cycle_stamp;
+    }
+    //consecutive corners that start in the same vertex enter and leave the cycle
+    //at that vertex
+    int first = (corners[0]->start == corners[1]->start) ? 0 : 1;
+    boolean right_side_empty = TRUE, left_side_empty = TRUE;
+    for(int i = first; i < length; i += 2){
+        PG_EDGE *in = corners[i];
+        PG_EDGE *out = corners[(i + 1) % length];
+        if(right_side_empty && !sector_only_contains_cycle_vertices(in, out, data)){
+            right_side_empty = FALSE;
+        }
+        if(left_side_empty && !sector_only_contains_cycle_vertices(out, in, data)){
+            left_side_empty = FALSE;
+        }
+    }
+    return !right_side_empty && !left_side_empty;
+}
+
+static void store_separator(PG_EDGE **corners, int length, int *separator, int *separator_size){
+    int size = 0;
+    int first = (corners[0]->start == corners[1]->start) ? 0 : 1;
+    for(int i = first; i < length; i += 2){
+        if(separator != NULL){
+            separator[size] = corners[i]->start;
+        }
+        size++;
+    }
+    if(separator_size != NULL){
+        *separator_size = size;
+    }
+}
+
+static PG_EDGE *get_first_corner(PLANE_GRAPH *graph, int element){
+    return element < graph->nv ? graph->first_edge[element] : graph->face_start[element - graph->nv];
+}
+
+/**
+ * Returns the next corner when walking clockwise around a vertex or a face.
+ */
+static PG_EDGE *get_next_corner(PLANE_GRAPH *graph, int element, PG_EDGE *corner){
+    return element < graph->nv ? corner->next : corner->inverse->prev;
+}
+
+/**
+ * Returns the element at the other side of the corner.
+ */
+static int get_other_element(PLANE_GRAPH *graph, PG_EDGE *corner, int element){
+    return element < graph->nv ? FACE_ELEMENT(graph, corner->right_face) : corner->start;
+}
+
+static int get_element_degree(PLANE_GRAPH *graph, int element){
+    return element < graph->nv ? graph->degree[element] : graph->face_size[element - graph->nv];
+}
+
+/**
+ * Sorts the elements of the incidence graph by decreasing degree using counting sort.
+ */
+static void order_elements_by_decreasing_degree(PLANE_GRAPH *graph, PG_SEPARATOR_DATA *data){
+    int element_count = graph->nv + graph->nf;
+    int max_degree = 0;
+    for(int x = 0; x < element_count; x++){
+        if(get_element_degree(graph, x) > max_degree){
+            max_degree = get_element_degree(graph, x);
+        }
+    }
+    int *count = (int *)calloc(max_degree + 1, sizeof(int));
+    if(count == NULL){
+        fprintf(stderr, "Insufficient memory for vertex connectivity -- exiting!\n");
+        exit(EXIT_FAILURE);
+    }
+    for(int x = 0; x < element_count; x++){
+        count[max_degree - get_element_degree(graph, x)]++;
+    }
+    int position = 0;
+    for(int d = 0; d <= max_degree; d++){
+        int elements_of_degree = count[d];
+        count[d] = position;
+        position += elements_of_degree;
+    }
+    for(int x = 0; x < element_count; x++){
+        int i = count[max_degree - get_element_degree(graph, x)]++;
+        data->order[i] = x;
+        data->rank[x] = i;
+    }
+    free(count);
+}
+
+/**
+ * Looks for a separator of size 2, i.e., a separating cycle of length 4 in the
+ * incidence graph. As for quadrangles, the elements are handled by decreasing
+ * degree and each cycle is found from its first element x as two paths of 
+ * length 2 to the same element z. Only two paths with neighbouring middle 
+ * elements around x and z can form a cycle with an empty side, so each new
+ * path is compared to at most 3 stored paths before a separator is found. 
+ * @return TRUE if a separator was found
+ */
+static boolean find_separator_of_size_two(PLANE_GRAPH *graph, PG_SEPARATOR_DATA *data,
+                                          int *separator, int *separator_size){
+    int element_count = graph->nv + graph->nf;
+    for(int i = 0; i < element_count; i++){
+        int x = data->order[i];
+        int stamp = ++data->stamp;
+        PG_EDGE *first_corner = get_first_corner(graph, x);
+        for(int j = 0; j < get_element_degree(graph, x); j++){
+            int y = get_other_element(graph, first_corner, x);
+            if(data->rank[y] > i){
+                PG_EDGE *second_corner = get_first_corner(graph, y);
+                for(int l = 0; l < get_element_degree(graph, y); l++){
+                    int z = get_other_element(graph, second_corner, y);
+                    if(z != x && data->rank[z] > i){
+                        if(data->mark[z] != stamp){
+                            data->mark[z] = stamp;
+                            data->stored_path_count[z] = 0;
+                        }
+                        PG_EDGE **paths = data->stored_paths + 2*STORED_PATHS*z;
+                        for(int m = 0; m < data->stored_path_count[z]; m++){
+                            PG_EDGE *corners[4] = {paths[2*m], paths[2*m + 1], second_corner, first_corner};
+                            if(is_separating_cycle(corners, 4, data)){
+                                store_separator(corners, 4, separator, separator_size);
+                                return TRUE;
+                            }
+                        }
+                        if(data->stored_path_count[z] < STORED_PATHS){
+                            paths[2*data->stored_path_count[z]] = first_corner;
+                            paths[2*data->stored_path_count[z] + 1] = second_corner;
+                            data->stored_path_count[z]++;
+                        }
+                    }
+                    second_corner = get_next_corner(graph, y, second_corner);
+                }
+            }
+            first_corner = get_next_corner(graph, x, first_corner);
+        }
+    }
+    return FALSE;
+}
+
+/**
+ * Extends the current path in the incidence graph in all possible ways to a 
+ * cycle of the given length through the anchor that only contains elements
+ * that come after the anchor in the order. 
+ * @param element the last element of the current path
+ * @param length the number of corners in the current path
+ * @return TRUE if a separating cycle was found
+ */
+static boolean extend_path_to_separating_cycle(PLANE_GRAPH *graph, int anchor_rank, int element,
+                                               int length, int cycle_length, PG_SEPARATOR_DATA *data,
+                                               int *separator, int *separator_size){
+    if(length == cycle_length - 1){
+        if(data->mark[element] != data->stamp){
+            return FALSE;
+        }
+        data->path[length] = data->corner_to_anchor[element];
+        if(is_separating_cycle(data->path, cycle_length, data)){
+            store_separator(data->path, cycle_length, separator, separator_size);
+            return TRUE;
+        }
+        return FALSE;
+    }
+    PG_EDGE *corner = get_first_corner(graph, element);
+    for(int j = 0; j < get_element_degree(graph, element); j++){
+        int next = get_other_element(graph, corner, element);
+        if(data->rank[next] > anchor_rank && data->on_path[next] != data->stamp){
+            data->on_path[next] = data->stamp;
+            data->path[length] = corner;
+            boolean found = extend_path_to_separating_cycle(graph, anchor_rank, next, length + 1, 
+                                                            cycle_length, data, separator, separator_size);
+            data->on_path[next] = 0;
+            if(found){
+                return TRUE;
+            }
+        }
+        corner = get_next_corner(graph, element, corner);
+    }
+    return FALSE;
+}
+
+/**
+ * Looks for a separator of the given size, i.e., a separating cycle in the 
+ * incidence graph of twice that size. Each cycle is found from its first 
+ * element in the order by enumerating the paths through the elements that
+ * come later. 
+ * @return TRUE if a separator was found
+ */
+static boolean find_separator_of_size(PLANE_GRAPH *graph, int size, PG_SEPARATOR_DATA *data,
+                                      int *separator, int *separator_size){
+    int element_count = graph->nv + graph->nf;
+    for(int i = 0; i < element_count; i++){
+        int x = data->order[i];
+        data->stamp++;
+        PG_EDGE *corner = get_first_corner(graph, x);
+        for(int j = 0; j < get_element_degree(graph, x); j++){
+            int y = get_other_element(graph, corner, x);
+            data->mark[y] = data->stamp;
+            data->corner_to_anchor[y] = corner;
+            corner = get_next_corner(graph, x, corner);
+        }
+        data->on_path[x] = data->stamp;
+        if(extend_path_to_separating_cycle(graph, i, x, 0, 2*size, data, separator, separator_size)){
+            return TRUE;
+        }
+    }
+    return FALSE;
+}
+
+/**
+ * Looks for a vertex separator smaller than maximum in a 2-connected graph.
+ * The separators are searched by increasing size, so the separator that is 
+ * found is a smallest separator. Only separators with at most 4 vertices are
+ * searched: a simple plane graph has a vertex of degree at most 5, whose 
+ * neighbours form a separator unless the graph is complete.
+ * @param graph a 2-connected simple plane graph for which the faces are constructed
+ * @param maximum
+ * @return the size of the separator that was found, or 0 if there is no 
+ *         separator smaller than maximum with at most 4 vertices
+ */
+static int find_small_separator(PLANE_GRAPH *graph, int maximum, int *separator, int *separator_size){
+    int element_count = graph->nv + graph->nf;
+    PG_SEPARATOR_DATA data;
+    data.order = (int *)malloc(sizeof(int) * element_count);
+    data.rank = (int *)malloc(sizeof(int) * element_count);
+    data.mark = (int *)calloc(element_count, sizeof(int));
+    data.corner_to_anchor = (PG_EDGE **)malloc(sizeof(PG_EDGE *) * element_count);
+    data.stored_path_count = (int *)malloc(sizeof(int) * element_count);
+    data.stored_paths = (PG_EDGE **)malloc(sizeof(PG_EDGE *) * 2 * STORED_PATHS * element_count);
+    data.on_path = (int *)calloc(element_count, sizeof(int));
+    data.on_cycle = (int *)calloc(graph->nv, sizeof(int));
+    data.stamp = data.cycle_stamp = 0;
+    if(data.order == NULL || data.rank == NULL || data.mark == NULL || data.corner_to_anchor == NULL ||
+            data.stored_path_count == NULL || data.stored_paths == NULL || data.on_path == NULL ||
+            data.on_cycle == NULL){
+        fprintf(stderr, "Insufficient memory for vertex connectivity -- exiting!\n");
+        exit(EXIT_FAILURE);
+    }
+    
+    order_elements_by_decreasing_degree(graph, &data);
+    int size = 0;
+    if(maximum > 2 && find_separator_of_size_two(graph, &data, separator, separator_size)){
+        size = 2;
+    }
+    for(int k = 3; !size && k < maximum && k <= MAXIMUM_SEPARATOR_SEARCH; k++){
+        if(find_separator_of_size(graph, k, &data, separator, separator_size)){
+            size = k;
+        }
+    }
+    
+    free(data.order);
+    free(data.rank);
+    free(data.mark);
+    free(data.corner_to_anchor);
+    free(data.stored_path_count);
+    free(data.stored_paths);
+    free(data.on_path);
+    free(data.on_cycle);
+    
+    return size;
+}
+
+/**
+ * Stores the neighbours of a vertex of minimum degree as a separator.
+ * @return the minimum degree
+ */
+static int store_neighbourhood_separator(PLANE_GRAPH *graph, int *separator, int *separator_size){
+    int v = 0;
+    for(int i = 1; i < graph->nv; i++){
+        if(graph->degree[i] < graph->degree[v]){
+            v = i;
+        }
+    }
+    if(separator != NULL){
+        PG_EDGE *e = graph->first_edge[v];
+        for(int i = 0; i < graph->degree[v]; i++){
+            separator[i] = e->end;
+            e = e->next;
+        }
+    }
+    if(separator_size != NULL){
+        *separator_size = graph->degree[v];
+    }
+    return graph->degree[v];
+}
+
+boolean is_k_connected(PLANE_GRAPH *graph, int k, int *separator, int *separator_size){
+    if(!graph->faces_constructed){
+        fprintf(stderr, "The faces of the graph have not been constructed -- exiting!\n");
+        exit(EXIT_FAILURE);
+    }
+    if(k <= 0){
+        return TRUE;
+    }
+    if(graph->nv <= k){
+        //a complete graph on k vertices is only (k-1)-connected
+        if(separator_size != NULL){
+            *separator_size = 0;
+        }
+        return FALSE;
+    }
+    if(minimum_degree(graph) < k){
+        store_neighbourhood_separator(graph, separator, separator_size);
+        return FALSE;
+    }
+    int cut_vertex;
+    if(!find_cut_vertex(graph, &cut_vertex)){
+        if(separator_size != NULL){
+            *separator_size = 0;
+        }
+        return FALSE;
+    }
+    if(k == 1){
+        return TRUE;
+    }
+    if(cut_vertex != -1){
+        if(separator != NULL){
+            separator[0] = cut_vertex;
+        }
+        if(separator_size != NULL){
+            *separator_size = 1;
+        }
+        return FALSE;
+    }
+    return !find_small_separator(graph, k, separator, separator_size);
+}
+
+int vertex_connectivity_with_separator(PLANE_GRAPH *graph, int *separator){
+    int cut_vertex;
+    if(!graph->faces_constructed){
+        return -1;
+    }
+    if(graph->nv == 1 || !find_cut_vertex(graph, &cut_vertex)){
+        return 0;
+    }
+    if(cut_vertex != -1){
+        if(separator != NULL){
+            separator[0] = cut_vertex;
+        }
+        return 1;
+    }
+    if(graph->nv == 2){
+        return 1;
+    }
+    int size;
+    if(find_small_separator(graph, minimum_degree(graph), separator, &size)){
+        return size;
+    }
+    int degree = store_neighbourhood_separator(graph, separator, NULL);
+    return degree < graph->nv - 1 ? degree : graph->nv - 1;
+}
+
+int vertex_connectivity(PLANE_GRAPH *graph){
+    return vertex_connectivity_with_separator(graph, NULL);
+}
+
+/* A cyclic edge-cut of a connected cubic plane graph is a cycle in the dual that
+ * has a face of the graph on both sides: the part of the graph on one side
+ * contains a cycle if and only if it contains a face. As for the edge-cuts, 
+ * the dual is never constructed.
+ */
+
+#define MAXIMUM_CYCLIC_CUT_SEARCH 5
+
+/* The scratch space for finding small cyclic edge-cuts. */
+typedef struct __pg_cyclic_cut_data {
+    PG_EDGE_CUT_DATA cut_data;
+    
+    //for each face the anchor (plus one) for which it is on the current path
+    int *on_path;
+    //for each face the last stamp with which it was marked as part of a cycle
+    int *on_cycle;
+    int cycle_stamp;
+    
+    //the edges of the current path in the dual
+    PG_EDGE *path[MAXIMUM_CYCLIC_CUT_SEARCH];
+} PG_CYCLIC_CUT_DATA;
+
+/**
+ * Checks the faces that are met when walking around a face of a dual cycle from
+ * the edge in to the edge out, i.e., the neighbours of that face on one side 
+ * of the dual cycle.
+ * @return TRUE if all these faces are on the cycle
+ */
+static boolean sector_only_contains_cycle_faces(PG_EDGE *in, PG_EDGE *out, PG_CYCLIC_CUT_DATA *data){
+    PG_EDGE *e = in;
+    do {
+        e = e->inverse->prev;
+        if(data->on_cycle[e->inverse->right_face] != data->cycle_stamp){
+            return FALSE;
+        }
+    } while (e != out);
+    return TRUE;
+}
+
+/**
+ * Checks whether the dual cycle given by its edges has faces on both sides. 
+ * Edge i of the cycle has face i on its right side and face i+1 on its left side.
+ * @return TRUE if the edges form a cyclic edge-cut
+ */
+static boolean is_cyclic_edge_cut(PG_EDGE **edges, int length, PG_CYCLIC_CUT_DATA *data){
+    data->cycle_stamp++;
+    for(int i = 0; i < length; i++){
+        data->on_cycle[edges[i]->right_face] = data->cycle_stamp;
+    }
+    boolean right_side_empty = TRUE, left_side_empty = TRUE;
+    for(int i = 0; i < length; i++){
+        PG_EDGE *in = edges[i]->inverse;
+        PG_EDGE *out = edges[(i + 1) % length];
+        if(right_side_empty && !sector_only_contains_cycle_faces(in, out, data)){
+            right_side_empty = FALSE;
+        }
+        if(left_side_empty && !sector_only_contains_cycle_faces(out, in, data)){
+            left_side_empty = FALSE;
+        }
+    }
+    return !right_side_empty && !left_side_empty;
+}
+
+/**
+ * Extends the current path in the dual in all possible ways to a cycle of the
+ * given length through the anchor that only contains faces that come after the
+ * anchor in the order. 
+ * @param face the last face of the current path
+ * @param length the number of edges in the current path
+ * @return TRUE if a cyclic edge-cut was found
+ */
+static boolean extend_path_to_cyclic_edge_cut(PLANE_GRAPH *graph, int anchor, int face, int length,
+                                              int cycle_length, PG_CYCLIC_CUT_DATA *data,
+                                              PG_EDGE **cut){
+    PG_EDGE_CUT_DATA *cut_data = &(data->cut_data);
+    int anchor_rank = cut_data->rank[anchor];
+    if(length == cycle_length - 1){
+        if(cut_data->mark[face] != anchor + 1){
+            return FALSE;
+        }
+        data->path[length] = cut_data->via[face]->inverse;
+        if(is_cyclic_edge_cut(data->path, cycle_length, data)){
+            store_cut(cut, NULL, data->path, cycle_length);
+            return TRUE;
+        }
+        return FALSE;
+    }
+    PG_EDGE *e = graph->face_start[face];
+    for(int j = 0; j < graph->face_size[face]; j++){
+        int next = e->inverse->right_face;
+        if(cut_data->rank[next] > anchor_rank && data->on_path[next] != anchor + 1){
+            data->on_path[next] = anchor + 1;
+            data->path[length] = e;
+            boolean found = extend_path_to_cyclic_edge_cut(graph, anchor, next, length + 1, 
+                                                           cycle_length, data, cut);
+            data->on_path[next] = 0;
+            if(found){
+                return TRUE;
+            }
+        }
+        e = e->inverse->prev;
+    }
+    return FALSE;
+}
+
+int cyclic_edge_connectivity(PLANE_GRAPH *graph, int maximum, PG_EDGE **cut){
+    if(maximum <= 1){
+        return maximum;
+    }
+    for(int v = 0; v < graph->nv; v++){
+        if(graph->degree[v] != 3){
+            return -1;
+        }
+    }
+    if(!graph->faces_constructed){
+        return -1;
+    }
+    
+    PG_CYCLIC_CUT_DATA data;
+    PG_EDGE_CUT_DATA *cut_data = &(data.cut_data);
+    cut_data->order = (int *)malloc(sizeof(int) * graph->nf);
+    cut_data->rank = (int *)malloc(sizeof(int) * graph->nf);
+    cut_data->mark = (int *)calloc(graph->nf, sizeof(int));
+    cut_data->via = (PG_EDGE **)malloc(sizeof(PG_EDGE *) * graph->nf);
+    cut_data->second_via = NULL;
+    data.on_path = (int *)calloc(graph->nf, sizeof(int));
+    data.on_cycle = (int *)calloc(graph->nf, sizeof(int));
+    data.cycle_stamp = 0;
+    if(cut_data->order == NULL || cut_data->rank == NULL || cut_data->mark == NULL || 
+            cut_data->via == NULL || data.on_path == NULL || data.on_cycle == NULL){
+        fprintf(stderr, "Insufficient memory for cyclic edge connectivity -- exiting!\n");
+        exit(EXIT_FAILURE);
+    }
+    
+    //in a cubic graph both sides of a bridge or of an edge-cut of size 2 contain a cycle
+    int size = find_edge_cut_of_size_at_most_two(graph, maximum, cut_data, cut, NULL);
+    if(!size && maximum > 3){
+        order_faces_by_decreasing_size(graph, cut_data);
+        for(int f = 0; f < graph->nf; f++){
+            cut_data->mark[f] = 0;
+        }
+        for(int k = 3; !size && k < maximum && k <= MAXIMUM_CYCLIC_CUT_SEARCH; k++){
+            for(int i = 0; i < graph->nf && !size; i++){
+                int anchor = cut_data->order[i];
+                PG_EDGE *e = graph->face_start[anchor];
+                for(int j = 0; j < graph->face_size[anchor]; j++){
+                    cut_data->mark[e->inverse->right_face] = anchor + 1;
+                    cut_data->via[e->inverse->right_face] = e;
+                    e = e->inverse->prev;
+                }
+                data.on_path[anchor] = anchor + 1;
+                if(extend_path_to_cyclic_edge_cut(graph, anchor, anchor, 0, k, &data, cut)){
+                    size = k;
+                }
+                data.on_path[anchor] = 0;
+            }
+        }
+    }
+    
+    free(cut_data->order);
+    free(cut_data->rank);
+    free(cut_data->mark);
+    free(cut_data->via);
+    free(data.on_path);
+    free(data.on_cycle);
+    
+    if(size){
+        return size;
+    } else if(maximum <= MAXIMUM_CYCLIC_CUT_SEARCH + 1){
+        return maximum;
+    } else {
+        //each face of size at most 5 gives a cyclic edge-cut, unless the graph
+        //is K4 which has no cyclic edge-cut
+        return (graph->ne / 2 < maximum) ? graph->ne / 2 : maximum;
+    }
+}
+
 /**
  * Compute the edge connectivity of the given graph.
  * @param graph
  * @return the size of a smallest edge-cut
  */
 int edge_connectivity(PLANE_GRAPH *graph){
-    PLANE_GRAPH *dual = get_dual_graph(graph);
-    int edge_connectivity = shorter_cycle(dual, minimum_degree(graph));
-    free_plane_graph(dual);
-    return edge_connectivity;
+    return edge_connectivity_with_cut(graph, NULL);
 }
 
 /**
@@ -28,4 +1082,4 @@ int edge_connectivity(PLANE_GRAPH *graph){
  */
 int edge_connectivity_dual(PLANE_GRAPH *dual){
     return shortest_cycle(dual);
-}
\ No newline at end of file
+}
@@ -11,12 +11,45 @@
 #include "planegraphs_base.h"
 
 /**
- * Compute the edge connectivity of the given graph.
+ * Compute the edge connectivity of the given graph. The faces of the graph 
+ * should be constructed.
  * @param graph
- * @return the size of a smallest edge-cut
+ * @return the size of a smallest edge-cut, or -1 if the faces of the graph have
+ *         not been constructed
  */
 int edge_connectivity(PLANE_GRAPH *graph);
 
+/**
+ * Compute the edge connectivity of the given graph and a smallest edge-cut. The
+ * cut is found by walking the faces of the graph, so the dual graph is not
+ * constructed. The faces of the graph should be constructed.
+ * @param graph a connected plane graph
+ * @param cut if not NULL, this will contain for each edge in a smallest cut one
+ *            of its two oriented edges. There should be room for at least the 
+ *            minimum degree of the graph.
+ * @return the size of a smallest edge-cut, or -1 if the faces of the graph have
+ *         not been constructed
+ */
+int edge_connectivity_with_cut(PLANE_GRAPH *graph, PG_EDGE **cut);
+
+/**
+ * Decides whether the given graph is k-edge-connected. This returns as soon as
+ * an edge-cut with less than k edges is found, and runs in linear time for
+ * k <= 5. Only graphs with parallel edges can have minimum degree larger than
+ * 5. For those graphs, larger cuts are found by breadth-first searches of depth
+ * at most (k-1)/2 in the dual. The faces of the graph should be constructed;
+ * this function exits otherwise.
+ * @param graph a connected plane graph
+ * @param k
+ * @param cut if not NULL and the graph is not k-edge-connected, this will contain
+ *            for each edge in a cut with less than k edges one of its two 
+ *            oriented edges. There should be room for at least k-1 edges.
+ * @param cut_size if not NULL and the graph is not k-edge-connected, this will
+ *                 contain the size of the cut
+ * @return TRUE if the graph is k-edge-connected, and FALSE otherwise
+ */
+boolean is_k_edge_connected(PLANE_GRAPH *graph, int k, PG_EDGE **cut, int *cut_size);
+
 /**
  * Compute the edge connectivity of the dual of the given graph.
  * @param graph
@@ -24,4 +57,68 @@ int edge_connectivity(PLANE_GRAPH *graph);
  */
 int edge_connectivity_dual(PLANE_GRAPH *dual);
 
+/**
+ * Compute the vertex connectivity of the given simple graph and a smallest 
+ * vertex separator. Cut vertices are found with a depth-first search. Larger
+ * separators are found as separating cycles in the vertex-face incidence graph,
+ * which is walked without being constructed. Separators of size 2 are found in
+ * linear time. Separators of size 3 and 4 are found by enumerating short cycles
+ * in the incidence graph, which is near-linear for graphs with small degrees and
+ * faces. The faces of the graph should be constructed.
+ * @param graph a simple plane graph
+ * @param separator if not NULL, this will contain the vertices of a smallest
+ *                  separator. If the graph is complete, then no separator exists
+ *                  and this will contain the neighbours of a vertex. There should
+ *                  be room for at least the minimum degree of the graph.
+ * @return the vertex connectivity of the graph, i.e., the size of a smallest
+ *         separator, or the number of vertices minus one if the graph is complete.
+ *         This is -1 if the faces of the graph have not been constructed.
+ */
+int vertex_connectivity_with_separator(PLANE_GRAPH *graph, int *separator);
+
+/**
+ * Compute the vertex connectivity of the given simple graph. The faces of the
+ * graph should be constructed.
+ * @param graph a simple plane graph
+ * @return the vertex connectivity of the graph, or -1 if the faces of the graph
+ *         have not been constructed
+ */
+int vertex_connectivity(PLANE_GRAPH *graph);
+
+/**
+ * Decides whether the given simple graph is k-connected, i.e., whether it has
+ * more than k vertices and no separator with less than k vertices. This returns 
+ * as soon as a separator with less than k vertices is found. The faces of the
+ * graph should be constructed; this function exits otherwise.
+ * @param graph a simple plane graph
+ * @param k
+ * @param separator if not NULL and the graph is not k-connected, this will 
+ *                  contain the vertices of a separator with less than k vertices.
+ *                  There should be room for at least k-1 vertices.
+ * @param separator_size if not NULL and the graph is not k-connected, this will
+ *                       contain the size of the separator. This is 0 if the graph
+ *                       is disconnected or has at most k vertices.
+ * @return TRUE if the graph is k-connected, and FALSE otherwise
+ */
+boolean is_k_connected(PLANE_GRAPH *graph, int k, int *separator, int *separator_size);
+
+/**
+ * Compute the cyclic edge connectivity of the given cubic graph if it is smaller
+ * than maximum, i.e., the size of a smallest edge-cut that separates two cycles.
+ * A cyclic edge-cut is found as a cycle in the dual that has faces on both 
+ * sides, so the search only walks the faces of the graph. It stops at the first
+ * cut smaller than maximum, and the cuts are searched by increasing size. The 
+ * faces of the graph should be constructed.
+ * @param graph a connected cubic plane graph
+ * @param maximum An upper bound for the cyclic edge connectivity
+ * @param cut if not NULL and a cyclic edge-cut smaller than maximum exists, this
+ *            will contain for each edge in a smallest such cut one of its two 
+ *            oriented edges. There should be room for at least 5 edges.
+ * @return the cyclic edge connectivity or maximum if the cyclic edge connectivity
+ *         is at least maximum. This is -1 if the graph is not cubic or its faces
+ *         have not been constructed. K4 has no 
+ *         cyclic edge-cut, and its cyclic edge connectivity is its number of edges.
+ */
+int cyclic_edge_connectivity(PLANE_GRAPH *graph, int maximum, PG_EDGE **cut);
+
 #endif //PLANEGRAPH_CONNECTIVITY_H
@@ -5,74 +5,691 @@
  * Licensed under the GNU GPL, read the file LICENSE.txt for details.
  */
 
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
 #include "planegraphs_base.h"
 #include "planegraphs_cycles.h"
 
+/* The scratch space of the girth engine. Each vertex has a bitset with one 
+ * bit for each of the (at most 64) sources of the breadth-first searches that
+ * are performed at the same time.
+ */
+struct __pg_girth_workspace {
+    int allocated_nv;
+    
+    //the sources that have reached each vertex
+    uint64_t *visited;
+    //the sources for which each vertex is in the current level
+    uint64_t *frontier;
+    //the sources for which each vertex is in the next level
+    uint64_t *next;
+    //the sources for which each vertex can be reached from two vertices in the current level
+    uint64_t *twice;
+    
+    //the vertices in the current and in the next level of any of the searches
+    int *active;
+    int *next_active;
+    //all vertices that have been reached by any of the searches
+    int *reached;
+    
+};
+
+PG_GIRTH_WORKSPACE *new_girth_workspace(){
+    PG_GIRTH_WORKSPACE *workspace = (PG_GIRTH_WORKSPACE *)calloc(1, sizeof(PG_GIRTH_WORKSPACE));
+    if(workspace == NULL){
+        fprintf(stderr, "Insufficient memory for girth workspace -- exiting!\n");
+        exit(EXIT_FAILURE);
+    }
+    return workspace;
+}
+
+void free_girth_workspace(PG_GIRTH_WORKSPACE *workspace){
+    free(workspace->visited);
+    free(workspace->frontier);
+    free(workspace->next);
+    free(workspace->twice);
+    free(workspace->active);
+    free(workspace->next_active);
+    free(workspace->reached);
+    free(workspace);
+}
+
+static void prepare_girth_workspace(PG_GIRTH_WORKSPACE *workspace, int n){
+    if(n <= workspace->allocated_nv){
+        return;
+    }
+    free(workspace->visited);
+    free(workspace->frontier);
+    free(workspace->next);
+    free(workspace->twice);
+    free(workspace->active);
+    free(workspace->next_active);
+    free(workspace->reached);
+    
+    //the bitsets should be 0 for each vertex outside of the searches
+    workspace->visited = (uint64_t *)calloc(n, sizeof(uint64_t));
+    workspace->frontier = (uint64_t *)calloc(n, sizeof(uint64_t));
+    workspace->next = (uint64_t *)calloc(n, sizeof(uint64_t));
+    workspace->twice = (uint64_t *)calloc(n, sizeof(uint64_t));
+    workspace->active = (int *)malloc(sizeof(int) * n);
+    workspace->next_active = (int *)malloc(sizeof(int) * n);
+    workspace->reached = (int *)malloc(sizeof(int) * n);
+    if(workspace->visited == NULL || workspace->frontier == NULL || workspace->next == NULL ||
+            workspace->twice == NULL || workspace->active == NULL || workspace->next_active == NULL ||
+            workspace->reached == NULL){
+        fprintf(stderr, "Insufficient memory for shortest cycle -- exiting!\n");
+        exit(EXIT_FAILURE);
+    }
+    workspace->allocated_nv = n;
+}
+
 /**
- * Uses BFS to find the shortest cycle through the specified vertex.
+ * Looks for loops and parallel edges.
  * @param graph
- * @param v
+ * @param workspace
+ * @return 1 if the graph contains a loop, 2 if it contains parallel edges, and
+ *         the number of vertices plus one otherwise
+ */
+static int find_cycle_of_length_at_most_two(PLANE_GRAPH *graph, PG_GIRTH_WORKSPACE *workspace){
+    //next is 0 for all vertices and is used to mark the neighbours of vertex v with v + 1
+    uint64_t *neighbour_of = workspace->next;
+    int shortest_cycle = graph->nv + 1;
+    
+    for(int v = 0; v < graph->nv && shortest_cycle > 1; v++){
+        PG_EDGE *e, *e_last;
+        e = e_last = graph->first_edge[v];
+        do {
+            if(e->end == v){
+                shortest_cycle = 1;
+                break;
+            } else if(neighbour_of[e->end] == (uint64_t)v + 1){
+                shortest_cycle = 2;
+            }
+            neighbour_of[e->end] = (uint64_t)v + 1;
+            e = e->next;
+        } while (e != e_last);
+    }
+    
+    for(int v = 0; v < graph->nv; v++){
+        neighbour_of[v] = 0;
+    }
+    return shortest_cycle;
+}
+
+/**
+ * Uses simultaneous breadth-first searches from the given sources to find the
+ * shortest cycle through any of these sources. All levels of the searches are
+ * handled at the same time: level d of the search from the i-th source is 
+ * given by the vertices for which bit i is set in frontier. 
+ * @param graph
+ * @param sources
+ * @param source_count at most 64
  * @param current_best An upper bound for the return value
- * @return the minimum of current_best and the length of the shortest cycle through the given vertex.
+ * @param workspace
+ * @return the minimum of current_best and the length of the shortest cycle through
+ *         one of the sources
  */
-int improve_shortest_cycle(PLANE_GRAPH *graph, int v, int current_best) {
-    //store the number of vertices just to have more readable code below
-    int n = graph->nv;
+static int improve_shortest_cycle_from_sources(PLANE_GRAPH *graph, int *sources, int source_count,
+                                               int current_best, PG_GIRTH_WORKSPACE *workspace){
+    uint64_t *visited = workspace->visited;
+    uint64_t *frontier = workspace->frontier;
+    uint64_t *next = workspace->next;
+    uint64_t *twice = workspace->twice;
+    int *active = workspace->active;
+    int *next_active = workspace->next_active;
+    int active_count = 0, next_active_count, reached_count = 0;
+    int i, distance = 0;
+    
+    for(i = 0; i < source_count; i++){
+        frontier[sources[i]] = visited[sources[i]] = ((uint64_t)1) << i;
+        active[active_count++] = workspace->reached[reached_count++] = sources[i];
+    }
+    
+    while(active_count && 2*distance + 1 < current_best){
+        //an odd cycle is an edge between two vertices in the same level, and
+        //an even cycle is a vertex in the next level with two neighbours in this level
+        boolean odd_cycle = FALSE;
+        boolean build_next_level = 2*distance + 2 < current_best;
+        next_active_count = 0;
+        PG_STATS_ADD(PG_STATS_BFS_NODES_VISITED, active_count);
+        for(i = 0; i < active_count && !odd_cycle; i++){
+            int vertex = active[i];
+            uint64_t sources_at_vertex = frontier[vertex];
+            PG_EDGE *e, *e_last;
+            e = e_last = graph->first_edge[vertex];
+            do {
+                int neighbour = e->end;
+                if(sources_at_vertex & frontier[neighbour]){
+                    odd_cycle = TRUE;
+                    break;
+                }
+                uint64_t new_sources = sources_at_vertex & ~visited[neighbour];
+                if(new_sources && build_next_level){
+                    if(!next[neighbour]){
+                        next_active[next_active_count++] = neighbour;
+                    }
+                    twice[neighbour] |= next[neighbour] & new_sources;
+                    next[neighbour] |= new_sources;
+                }
+                e = e->next;
+            } while (e != e_last);
+        }
+        if(odd_cycle){
+            current_best = 2*distance + 1;
+        }
+        
+        //move to the next level
+        for(i = 0; i < active_count; i++){
+            frontier[active[i]] = 0;
+        }
+        for(i = 0; i < next_active_count; i++){
+            int vertex = next_active[i];
+            if(twice[vertex] && 2*distance + 2 < current_best){
+                current_best = 2*distance + 2;
+            }
+            if(!visited[vertex]){
+                workspace->reached[reached_count++] = vertex;
+            }
+            visited[vertex] |= next[vertex];
+            frontier[vertex] = next[vertex];
+            next[vertex] = twice[vertex] = 0;
+        }
+        int *temp = active;
+        active = next_active;
+        next_active = temp;
+        active_count = next_active_count;
+        distance++;
+    }
+    
+    //only reset the vertices that were reached
+    for(i = 0; i < reached_count; i++){
+        visited[workspace->reached[i]] = frontier[workspace->reached[i]] = 0;
+    }
+    return current_best;
+}
 
-    int queue[n];
-    int head = 0;
-    int tail = 0;
+int shorter_cycle_with_workspace(PLANE_GRAPH *graph, int maximum, PG_GIRTH_WORKSPACE *workspace){
+    PG_STATS_START(PG_STATS_PHASE_SHORTEST_CYCLE);
+    //initially we set shortest_cycle to the size of the smallest face, if faces have been constructed
+    int shortest_cycle = maximum;
+    if(graph->nv + 1 < shortest_cycle){
+        shortest_cycle = graph->nv + 1;
+    }
+    if(graph->faces_constructed){
+        for (int i = 0; i < graph->nf; ++i) {
+            if(graph->face_size[i] < shortest_cycle){
+                shortest_cycle = graph->face_size[i];
+            }
+        }
+    }
+    
+    prepare_girth_workspace(workspace, graph->nv);
+    
+    //cycles of length 1 and 2 are found directly, so the searches can stop at 3
+    int short_cycle = find_cycle_of_length_at_most_two(graph, workspace);
+    if(short_cycle < shortest_cycle){
+        PG_STATS_STOP(PG_STATS_PHASE_SHORTEST_CYCLE);
+        return short_cycle;
+    }
 
-    int distance_to_v[n];
-    for(int i=0; i<n; i++){
-        distance_to_v[i]=-1;
+    //start 64 searches at once until all vertices have been used as a source:
+    //consecutive vertices are used together, since they are often close to each
+    //other, in which case their searches mostly visit the same vertices
+    int sources[64];
+    for(int i = 0; i < graph->nv && shortest_cycle > 3; i += 64){
+        int count = graph->nv - i < 64 ? graph->nv - i : 64;
+        for(int j = 0; j < count; j++){
+            sources[j] = i + j;
+        }
+        shortest_cycle = improve_shortest_cycle_from_sources(graph, sources, count, shortest_cycle, workspace);
+    }
+    PG_STATS_STOP(PG_STATS_PHASE_SHORTEST_CYCLE);
+
+    return shortest_cycle;
+}
+
+/**
+ * Compute the length of a shortest cycle in the graph if it is shorter than maximum.
+ * @param graph
+ * @param maximum An upper bound for the shortest cycle
+ * @return the length of a shortest cycle or the number of vertices plus one if the graph is acyclic
+ */
+int shorter_cycle(PLANE_GRAPH *graph, int maximum){
+    PG_GIRTH_WORKSPACE *workspace = new_girth_workspace();
+    int shortest_cycle = shorter_cycle_with_workspace(graph, maximum, workspace);
+    free_girth_workspace(workspace);
+    return shortest_cycle;
+}
+
+/**
+ * Compute the length of a shortest cycle in the graph
+ * @param graph
+ * @return the length of a shortest cycle or the number of vertices plus one if the graph is acyclic
+ */
+int shortest_cycle(PLANE_GRAPH *graph){
+    return shorter_cycle(graph, graph->nv + 1);
+}
+
+/* The scratch space for deciding whether the girth is at least k. */
+typedef struct __pg_girth_decision_data {
+    //the vertices sorted by decreasing degree, and the position of each vertex in that order
+    int *order;
+    int *rank;
+    
+    //for each vertex the last vertex (plus one) for which it was marked
+    int *mark;
+    //for each vertex the neighbour through which it was marked
+    int *via;
+    
+    //the breadth-first search for longer cycles
+    int *distance;
+    int *parent;
+    int *queue;
+} PG_GIRTH_DECISION_DATA;
+
+/**
+ * Stores the cycle in the given array if it is not NULL.
+ */
+static void store_cycle(int *cycle, int *cycle_length, int *vertices, int length){
+    if(cycle != NULL){
+        for(int i = 0; i < length; i++){
+            cycle[i] = vertices[i];
+        }
+    }
+    if(cycle_length != NULL){
+        *cycle_length = length;
+    }
+}
+
+/**
+ * Looks for a face of size less than k whose boundary is a cycle.
+ * @return TRUE if such a face was found
+ */
+static boolean find_short_facial_cycle(PLANE_GRAPH *graph, int k, PG_GIRTH_DECISION_DATA *data,
+                                       int *cycle, int *cycle_length){
+    for(int i = 0; i < graph->nf; i++){
+        if(graph->face_size[i] >= k){
+            continue;
+        }
+        //the boundary is a cycle if no vertex is visited twice
+        boolean is_cycle = TRUE;
+        PG_EDGE *e = graph->face_start[i];
+        for(int j = 0; j < graph->face_size[i]; j++){
+            if(data->mark[e->start] == -(i + 1)){
+                is_cycle = FALSE;
+                break;
+            }
+            data->mark[e->start] = -(i + 1);
+            e = e->inverse->prev;
+        }
+        if(is_cycle){
+            if(cycle != NULL){
+                e = graph->face_start[i];
+                for(int j = 0; j < graph->face_size[i]; j++){
+                    cycle[j] = e->start;
+                    e = e->inverse->prev;
+                }
+            }
+            if(cycle_length != NULL){
+                *cycle_length = graph->face_size[i];
+            }
+            return TRUE;
+        }
+    }
+    return FALSE;
+}
+
+/**
+ * Looks for a loop, or for parallel edges if k is larger than 2.
+ * @return TRUE if such a cycle was found
+ */
+static boolean find_loop_or_parallel_edges(PLANE_GRAPH *graph, int k, PG_GIRTH_DECISION_DATA *data,
+                                           int *cycle, int *cycle_length){
+    for(int v = 0; v < graph->nv; v++){
+        PG_EDGE *e, *e_last;
+        e = e_last = graph->first_edge[v];
+        do {
+            if(e->end == v){
+                store_cycle(cycle, cycle_length, &v, 1);
+                return TRUE;
+            } else if(k > 2 && data->mark[e->end] == v + 1){
+                int vertices[2] = {v, e->end};
+                store_cycle(cycle, cycle_length, vertices, 2);
+                return TRUE;
+            }
+            data->mark[e->end] = v + 1;
+            e = e->next;
+        } while (e != e_last);
+    }
+    return FALSE;
+}
+
+/**
+ * Sorts the vertices by decreasing degree using counting sort. The graph
+ * should not contain loops or parallel edges, so that no degree exceeds nv-1.
+ */
+static void order_by_decreasing_degree(PLANE_GRAPH *graph, PG_GIRTH_DECISION_DATA *data){
+    int max_degree = maximum_degree(graph);
+    //use via to count the vertices of each degree
+    int *count = data->via;
+    for(int d = 0; d <= max_degree; d++){
+        count[d] = 0;
+    }
+    for(int v = 0; v < graph->nv; v++){
+        count[max_degree - graph->degree[v]]++;
+    }
+    int position = 0;
+    for(int d = 0; d <= max_degree; d++){
+        int vertices_of_degree = count[d];
+        count[d] = position;
+        position += vertices_of_degree;
+    }
+    for(int v = 0; v < graph->nv; v++){
+        int i = count[max_degree - graph->degree[v]]++;
+        data->order[i] = v;
+        data->rank[v] = i;
+    }
+}
+
+/* The searches for triangles and quadrangles handle the vertices by decreasing
+ * degree, and only look at the vertices that have not yet been handled. A 
+ * vertex u that is handled after v has degree at most the degree of v, so 
+ * scanning the neighbours of u for each neighbour v costs at most the sum over
+ * all edges of the smallest degree of its end points. This is linear for plane 
+ * graphs, since their arboricity is at most 3 (Chiba and Nishizeki).
+ */
+
+/**
+ * Looks for a triangle in a graph without loops and parallel edges.
+ * @return TRUE if a triangle was found
+ */
+static boolean find_triangle(PLANE_GRAPH *graph, PG_GIRTH_DECISION_DATA *data,
+                             int *cycle, int *cycle_length){
+    for(int v = 0; v < graph->nv; v++){
+        data->mark[v] = 0;
+    }
+    for(int i = 0; i < graph->nv; i++){
+        int v = data->order[i];
+        PG_EDGE *e, *e_last, *f, *f_last;
+        e = e_last = graph->first_edge[v];
+        do {
+            data->mark[e->end] = v + 1;
+            e = e->next;
+        } while (e != e_last);
+        
+        do {
+            int u = e->end;
+            if(data->rank[u] > i){
+                f = f_last = graph->first_edge[u];
+                do {
+                    int w = f->end;
+                    if(data->rank[w] > i && data->mark[w] == v + 1){
+                        int vertices[3] = {v, u, w};
+                        store_cycle(cycle, cycle_length, vertices, 3);
+                        return TRUE;
+                    }
+                    f = f->next;
+                } while (f != f_last);
+            }
+            e = e->next;
+        } while (e != e_last);
+    }
+    return FALSE;
+}
+
+/**
+ * Looks for a cycle of length 4 in a graph without loops and parallel edges:
+ * such a cycle exists if a vertex v has two paths of length 2 to the same vertex.
+ * @return TRUE if a cycle of length 4 was found
+ */
+static boolean find_quadrangle(PLANE_GRAPH *graph, PG_GIRTH_DECISION_DATA *data,
+                               int *cycle, int *cycle_length){
+    for(int v = 0; v < graph->nv; v++){
+        data->mark[v] = 0;
+    }
+    for(int i = 0; i < graph->nv; i++){
+        int v = data->order[i];
+        PG_EDGE *e, *e_last, *f, *f_last;
+        e = e_last = graph->first_edge[v];
+        do {
+            int u = e->end;
+            if(data->rank[u] > i){
+                f = f_last = graph->first_edge[u];
+                do {
+                    int w = f->end;
+                    if(w != v && data->rank[w] > i){
+                        if(data->mark[w] == v + 1){
+                            int vertices[4] = {v, data->via[w], w, u};
+                            store_cycle(cycle, cycle_length, vertices, 4);
+                            return TRUE;
+                        }
+                        data->mark[w] = v + 1;
+                        data->via[w] = u;
+                    }
+                    f = f->next;
+                } while (f != f_last);
+            }
+            e = e->next;
+        } while (e != e_last);
+    }
+    return FALSE;
+}
+
+/**
+ * Stores the cycle that consists of the edge from u to w and the paths from u
+ * and from the given vertex (either w or its parent) to their common ancestor
+ * in the breadth-first search tree. 
+ */
+static void store_cycle_in_search_tree(int u, int w, int w_side_start, PG_GIRTH_DECISION_DATA *data,
+                                       int *cycle, int *cycle_length){
+    //both sides are at the same depth, so they reach the common ancestor at the same time
+    int steps = 0;
+    int x = u, y = w_side_start;
+    while(x != y){
+        x = data->parent[x];
+        y = data->parent[y];
+        steps++;
+    }
+    int w_side_length = (w_side_start == w) ? steps : steps + 1;
+    int length = steps + 1 + w_side_length;
+    
+    if(cycle != NULL){
+        //the path from u to the common ancestor, followed by the path back to w
+        x = u;
+        for(int i = 0; i <= steps; i++){
+            cycle[i] = x;
+            x = data->parent[x];
+        }
+        y = w;
+        for(int i = length - 1; i > steps; i--){
+            cycle[i] = y;
+            y = data->parent[y];
+        }
+    }
+    if(cycle_length != NULL){
+        *cycle_length = length;
     }
-    queue[head] = v;
+}
 
+/**
+ * Looks for a cycle of length less than k through v by performing a 
+ * breadth-first search that stops at depth (k-1)/2. Just like the searches for
+ * triangles and quadrangles, the vertices are handled by decreasing degree and
+ * the search only visits the vertices that have not yet been handled: a short
+ * cycle through a vertex that was handled before v has already been found.
+ * This way a vertex of high degree is only visited by its own search and by
+ * the searches of its neighbours of at least the same degree, instead of by
+ * the searches of all vertices within distance (k-1)/2.
+ * @return TRUE if a cycle shorter than k was found
+ */
+static boolean find_short_cycle_through_vertex(PLANE_GRAPH *graph, int v, int k, PG_GIRTH_DECISION_DATA *data,
+                                               int *cycle, int *cycle_length){
+    int head = 0, tail = 0;
+    boolean found = FALSE;
+    int first_rank = data->rank[v];
+    
+    data->queue[head++] = v;
+    data->distance[v] = 0;
+    data->parent[v] = v;
+    while (tail < head && !found) {
+        int vertex = data->queue[tail++];
+        int current_distance = data->distance[vertex];
+        if(2*current_distance + 1 >= k){
+            //even the shortest cycle through this level is too long
+            break;
+        }
+        PG_EDGE *e, *e_last;
+        e = e_last = graph->first_edge[vertex];
+        do {
+            int neighbour = e->end;
+            int neighbour_distance = data->distance[neighbour];
+            if(data->rank[neighbour] < first_rank){
+                //this vertex has already been handled
+            } else if(neighbour_distance < 0){
+                data->distance[neighbour] = current_distance + 1;
+                data->parent[neighbour] = vertex;
+                data->queue[head++] = neighbour;
+            } else if(neighbour_distance == current_distance){
+                store_cycle_in_search_tree(vertex, neighbour, neighbour, data, cycle, cycle_length);
+                found = TRUE;
+                break;
+            } else if(neighbour_distance > current_distance && 2*current_distance + 2 < k){
+                store_cycle_in_search_tree(vertex, neighbour, data->parent[neighbour], data, cycle, cycle_length);
+                found = TRUE;
+                break;
+            }
+            e = e->next;
+        } while (e != e_last);
+    }
+    
+    //only reset the vertices that were reached
+    for(int i = 0; i < head; i++){
+        data->distance[data->queue[i]] = -1;
+    }
+    return found;
+}
+
+boolean has_girth_at_least(PLANE_GRAPH *graph, int k, int *cycle, int *cycle_length){
+    if(k <= 1 || graph->nv == 0){
+        return TRUE;
+    }
+    
+    PG_GIRTH_DECISION_DATA data;
+    data.order = (int *)malloc(sizeof(int) * graph->nv);
+    data.rank = (int *)malloc(sizeof(int) * graph->nv);
+    data.mark = (int *)calloc(graph->nv, sizeof(int));
+    data.via = (int *)malloc(sizeof(int) * graph->nv);
+    data.distance = (int *)malloc(sizeof(int) * graph->nv);
+    data.parent = (int *)malloc(sizeof(int) * graph->nv);
+    data.queue = (int *)malloc(sizeof(int) * graph->nv);
+    if(data.order == NULL || data.rank == NULL || data.mark == NULL || data.via == NULL ||
+            data.distance == NULL || data.parent == NULL || data.queue == NULL){
+        fprintf(stderr, "Insufficient memory for girth decision -- exiting!\n");
+        exit(EXIT_FAILURE);
+    }
+    
+    boolean found;
+    if(graph->faces_constructed && find_short_facial_cycle(graph, k, &data, cycle, cycle_length)){
+        //a short face is the cheapest witness
+        found = TRUE;
+    } else {
+        //the facial marks are negative, so they do not interfere with the marks below
+        found = find_loop_or_parallel_edges(graph, k, &data, cycle, cycle_length);
+        if(!found && k > 3){
+            order_by_decreasing_degree(graph, &data);
+            found = find_triangle(graph, &data, cycle, cycle_length);
+            if(!found && k > 4){
+                found = find_quadrangle(graph, &data, cycle, cycle_length);
+            }
+        }
+        if(!found && k > 5){
+            //all cycles have length at least 5, so the searches only need to look for longer cycles
+            for(int v = 0; v < graph->nv; v++){
+                data.distance[v] = -1;
+            }
+            for(int i = 0; i < graph->nv && !found; i++){
+                found = find_short_cycle_through_vertex(graph, data.order[i], k, &data, cycle, cycle_length);
+            }
+        }
+    }
+    
+    free(data.order);
+    free(data.rank);
+    free(data.mark);
+    free(data.via);
+    free(data.distance);
+    free(data.parent);
+    free(data.queue);
+    
+    return !found;
+}
+
+/**
+ * Uses BFS to find the shortest cycle through the specified vertex of a compact graph.
+ * @param graph
+ * @param v
+ * @param current_best An upper bound for the return value
+ * @param queue scratch space for nv vertices
+ * @param distance_to_v scratch space for nv vertices, which should all be -1.
+ *                      On return all entries are -1 again.
+ * @return the minimum of current_best and the length of the shortest cycle through the given vertex.
+ */
+static int improve_shortest_cycle_compact(PG_COMPACT_GRAPH *graph, int v, int current_best,
+                                          int *queue, int *distance_to_v) {
+    const PG_COMPACT_EDGE *edges = graph->edges;
+    int head = 0;
+    int tail = 0;
     int lim = current_best / 2;
 
-    head ++;
+    queue[head++] = v;
     distance_to_v[v] = 0;
     while (head > tail) {
         int vertex = queue[tail];
         int current_distance = distance_to_v[vertex];
         if (current_distance >= lim)
-            return current_best; // can never improve current best
+            break; // can never improve current best
         tail ++;
-        PG_EDGE *e, *e_last;
+        uint32_t e, e_last;
         e = e_last = graph->first_edge[vertex];
         do {
-            int neighbour = e->end;
+            int neighbour = edges[e].end;
             int neighbour_distance = distance_to_v[neighbour];
             if (neighbour_distance < 0) {
                 // not yet encountered: set distance and add to queue
                 distance_to_v[neighbour] = current_distance + 1;
-                queue[head] = neighbour;
-                head ++;
+                queue[head++] = neighbour;
             } else if (neighbour_distance == current_distance) {
                 // odd cycle
-                return 2 * current_distance + 1;
+                current_best = 2 * current_distance + 1;
+                tail = head; // stop the search
+                break;
             } else if (neighbour_distance > current_distance) {
                 // even cycle
                 if (current_best > 2 * neighbour_distance) {
                     current_best = 2 * neighbour_distance; // == 2*current_distance+2
                 }
-            } //else {
-            // returns towards v, ignore
-            //}
-            e = e->next;
+            }
+            e = edges[e].next;
         } while (e != e_last);
     }
+    
+    //only reset the vertices that were reached
+    for(int i = 0; i < head; i++){
+        distance_to_v[queue[i]] = -1;
+    }
+    PG_STATS_ADD(PG_STATS_BFS_NODES_VISITED, tail);
     return current_best;
 }
 
 /**
- * Compute the length of a shortest cycle in the graph if it is shorter than maximum.
+ * Compute the length of a shortest cycle in the compact graph if it is shorter than maximum.
  * @param graph
  * @param maximum An upper bound for the shortest cycle
  * @return the length of a shortest cycle or the number of vertices plus one if the graph is acyclic
  */
-int shorter_cycle(PLANE_GRAPH *graph, int maximum){
+int shorter_cycle_compact(PG_COMPACT_GRAPH *graph, int maximum){
+    PG_STATS_START(PG_STATS_PHASE_SHORTEST_CYCLE);
     //initially we set shortest_cycle to the size of the smallest face, if faces have been constructed
     int shortest_cycle = maximum;
     if(graph->nv + 1 < shortest_cycle){
@@ -85,20 +702,34 @@ int shorter_cycle(PLANE_GRAPH *graph, int maximum){
             }
         }
     }
+    
+    int *queue = (int *)malloc(sizeof(int) * graph->nv);
+    int *distance_to_v = (int *)malloc(sizeof(int) * graph->nv);
+    if(queue == NULL || distance_to_v == NULL){
+        fprintf(stderr, "Insufficient memory for shortest cycle -- exiting!\n");
+        exit(EXIT_FAILURE);
+    }
+    for(int i=0; i<graph->nv; i++){
+        distance_to_v[i]=-1;
+    }
 
     //start BFS in each vertex to find a shorter cycle
     for(int i=0; i<graph->nv - 2; i++){
-        shortest_cycle = improve_shortest_cycle(graph, i, shortest_cycle);
+        shortest_cycle = improve_shortest_cycle_compact(graph, i, shortest_cycle, queue, distance_to_v);
     }
+    
+    free(queue);
+    free(distance_to_v);
+    PG_STATS_STOP(PG_STATS_PHASE_SHORTEST_CYCLE);
 
     return shortest_cycle;
 }
 
 /**
- * Compute the length of a shortest cycle in the graph
+ * Compute the length of a shortest cycle in the compact graph
  * @param graph
  * @return the length of a shortest cycle or the number of vertices plus one if the graph is acyclic
  */
-int shortest_cycle(PLANE_GRAPH *graph){
-    return shorter_cycle(graph, graph->nv + 1);
-}
\ No newline at end of file
+int shortest_cycle_compact(PG_COMPACT_GRAPH *graph){
+    return shorter_cycle_compact(graph, graph->nv + 1);
+}
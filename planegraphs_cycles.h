@@ -9,6 +9,7 @@
 #define PLANEGRAPH_CYCLES_H
 
 #include "planegraphs_base.h"
+#include "planegraphs_compact.h"
 
 /**
  * Compute the length of a shortest cycle in the graph if it is shorter than maximum.
@@ -18,6 +19,28 @@
  */
 int shorter_cycle(PLANE_GRAPH *graph, int maximum);
 
+typedef struct __pg_girth_workspace PG_GIRTH_WORKSPACE;
+
+/**
+ * Creates the scratch space used to compute the length of a shortest cycle.
+ * A workspace can be reused for graphs of any size, but can only be used by
+ * one thread at a time.
+ */
+PG_GIRTH_WORKSPACE *new_girth_workspace();
+
+void free_girth_workspace(PG_GIRTH_WORKSPACE *workspace);
+
+/**
+ * Compute the length of a shortest cycle in the graph if it is shorter than maximum.
+ * This performs breadth-first searches from 64 vertices at the same time, and 
+ * uses the given workspace instead of allocating memory for each graph.
+ * @param graph
+ * @param maximum An upper bound for the shortest cycle
+ * @param workspace
+ * @return the length of a shortest cycle or the number of vertices plus one if the graph is acyclic
+ */
+int shorter_cycle_with_workspace(PLANE_GRAPH *graph, int maximum, PG_GIRTH_WORKSPACE *workspace);
+
 /**
  * Compute the length of a shortest cycle in the graph
  * @param graph
@@ -25,4 +48,44 @@ int shorter_cycle(PLANE_GRAPH *graph, int maximum);
  */
 int shortest_cycle(PLANE_GRAPH *graph);
 
+/**
+ * Decides whether the graph has girth at least k, i.e., whether it contains no
+ * cycle shorter than k. Loops, parallel edges, triangles and cycles of length 4
+ * are found in linear time by exploiting the sparsity of plane graphs. Longer
+ * cycles are found using breadth-first searches of depth at most (k-1)/2. The
+ * vertices are handled by decreasing degree and each search only visits the
+ * vertices that have not yet been handled, so a vertex of high degree does not
+ * make the searches of all vertices around it expensive. For k > 5 the running
+ * time is the total size of these restricted balls. For a fixed k this is linear
+ * if all but a bounded number of vertices have bounded degree, as in a
+ * subdivided wheel, but the linear bound for all plane graphs only holds for
+ * k <= 5.
+ * If the faces have been constructed, then the faces are checked first.
+ * The function returns as soon as a cycle shorter than k is found.
+ * @param graph
+ * @param k
+ * @param cycle if not NULL and the girth is smaller than k, this will contain
+ *              the vertices of a cycle shorter than k in the order in which they
+ *              appear on that cycle. There should be room for at least k-1 vertices.
+ * @param cycle_length if not NULL and the girth is smaller than k, this will 
+ *                     contain the length of the cycle
+ * @return TRUE if the girth of the graph is at least k, and FALSE otherwise
+ */
+boolean has_girth_at_least(PLANE_GRAPH *graph, int k, int *cycle, int *cycle_length);
+
+/**
+ * Compute the length of a shortest cycle in the compact graph if it is shorter than maximum.
+ * @param graph
+ * @param maximum An upper bound for the shortest cycle
+ * @return the length of a shortest cycle or the number of vertices plus one if the graph is acyclic
+ */
+int shorter_cycle_compact(PG_COMPACT_GRAPH *graph, int maximum);
+
+/**
+ * Compute the length of a shortest cycle in the compact graph
+ * @param graph
+ * @return the length of a shortest cycle or the number of vertices plus one if the graph is acyclic
+ */
+int shortest_cycle_compact(PG_COMPACT_GRAPH *graph);
+
 #endif //PLANEGRAPH_CYCLES_H
@@ -0,0 +1,196 @@
+/*
+ * Main developer: Nico Van Cleemput
+ *
+ * Copyright (C) 2019 Nico Van Cleemput.
+ * Licensed under the GNU GPL, read the file LICENSE.txt for details.
+ */
+
+#include "planegraphs_dedup.h"
+#include "planegraphs_output.h"
+#include <stdlib.h>
+
+PG_CERTIFICATE_SET *new_certificate_set(size_t expected_size){
+    PG_CERTIFICATE_SET *set = (PG_CERTIFICATE_SET *)malloc(sizeof(PG_CERTIFICATE_SET));
+    
+    if(set == NULL){
+        fprintf(stderr, "Insufficient memory for certificate set.\n");
+        return NULL;
+    }
+    
+    set->capacity = 1024;
+    while(set->capacity < 2 * expected_size){
+        set->capacity *= 2;
+    }
+    set->count = 0;
+    set->hashes = (uint64_t *)calloc(2 * set->capacity, sizeof(uint64_t));
+    
+    if(set->hashes == NULL){
+        fprintf(stderr, "Insufficient memory for certificate set.\n");
+        free(set);
+        return NULL;
+    }
+    
+    return set;
+}
+
+void free_certificate_set(PG_CERTIFICATE_SET *set){
+    free(set->hashes);
+    free(set);
+}
+
+static inline uint64_t mix(uint64_t value){
+    value ^= value >> 33;
+    value *= 0xff51afd7ed558ccdULL;
+    value ^= value >> 33;
+    value *= 0xc4ceb9fe1a85ec53ULL;
+    value ^= value >> 33;
+    return value;
+}
+
+/**
+ * Computes two independent 64 bit hashes of the certificate.
+ */
+static void hash_canonical_form(PG_CANONICAL_FORM *form, uint64_t *hash){
+    uint64_t h1 = 0x9e3779b97f4a7c15ULL ^ (uint64_t)form->nv;
+    uint64_t h2 = 0x6a09e667f3bcc909ULL ^ ((uint64_t)form->certificate_length << 32);
+    
+    for(int i = 0; i < form->certificate_length; i++){
+        uint64_t value = (uint32_t)form->certificate[i];
+        h1 = (h1 ^ mix(value)) * 0x100000001b3ULL;
+        h1 = (h1 << 27) | (h1 >> 37);
+        h2 = (h2 + mix(value ^ 0xa5a5a5a5a5a5a5a5ULL)) * 0x9e3779b97f4a7c15ULL;
+        h2 ^= h2 >> 29;
+    }
+    
+    hash[0] = mix(h1);
+    hash[1] = mix(h2 ^ h1);
+    //0 0 is used for empty slots
+    if(hash[0] == 0 && hash[1] == 0){
+        hash[0] = 1;
+    }
+}
+
+static void insert_hash(uint64_t *hashes, size_t capacity, const uint64_t *hash){
+    size_t slot = hash[0] & (capacity - 1);
+    while(hashes[2*slot] || hashes[2*slot + 1]){
+        slot = (slot + 1) & (capacity - 1);
+    }
+    hashes[2*slot] = hash[0];
+    hashes[2*slot + 1] = hash[1];
+}
+
+static boolean grow_certificate_set(PG_CERTIFICATE_SET *set){
+    size_t new_capacity = 2 * set->capacity;
+    uint64_t *new_hashes = (uint64_t *)calloc(2 * new_capacity, sizeof(uint64_t));
+    
+    if(new_hashes == NULL){
+        fprintf(stderr, "Insufficient memory for certificate set.\n");
+        return FALSE;
+    }
+    
+    for(size_t i = 0; i < set->capacity; i++){
+        if(set->hashes[2*i] || set->hashes[2*i + 1]){
+            insert_hash(new_hashes, new_capacity, set->hashes + 2*i);
+        }
+    }
+    
+    free(set->hashes);
+    set->hashes = new_hashes;
+    set->capacity = new_capacity;
+    
+    return TRUE;
+}
+
+boolean add_canonical_form_to_certificate_set(PG_CERTIFICATE_SET *set, PG_CANONICAL_FORM *form){
+    uint64_t hash[2];
+    hash_canonical_form(form, hash);
+    
+    size_t slot = hash[0] & (set->capacity - 1);
+    while(set->hashes[2*slot] || set->hashes[2*slot + 1]){
+        if(set->hashes[2*slot] == hash[0] && set->hashes[2*slot + 1] == hash[1]){
+            return FALSE;
+        }
+        slot = (slot + 1) & (set->capacity - 1);
+    }
+    
+    if(2 * (set->count + 1) > set->capacity){
+        if(!grow_certificate_set(set)){
+            exit(-1);
+        }
+        insert_hash(set->hashes, set->capacity, hash);
+    } else {
+        set->hashes[2*slot] = hash[0];
+        set->hashes[2*slot + 1] = hash[1];
+    }
+    set->count++;
+    
+    return TRUE;
+}
+
+boolean add_graph_to_certificate_set_with_workspace(PG_CERTIFICATE_SET *set, PLANE_GRAPH *pg,
+                                                    PG_AUT_COMP_DATA *workspace){
+    PG_CANONICAL_FORM *form = determine_canonical_form_with_workspace(pg, workspace);
+    if(form == NULL){
+        exit(-1);
+    }
+    boolean is_new = add_canonical_form_to_certificate_set(set, form);
+    free_canonical_form(form);
+    return is_new;
+}
+
+boolean add_graph_to_certificate_set(PG_CERTIFICATE_SET *set, PLANE_GRAPH *pg){
+    return add_graph_to_certificate_set_with_workspace(set, pg, NULL);
+}
+
+boolean remove_isomorphic_copies(FILE *in, FILE *out, PG_INPUT_OPTIONS *options, boolean print_header,
+                                 unsigned long long *read, unsigned long long *written){
+    unsigned long long read_count = 0, written_count = 0;
+    boolean success = TRUE;
+    
+    PG_INPUT_OPTIONS reader_options = *options;
+    //the canonical form needs the faces
+    reader_options.construct_faces = TRUE;
+    
+    PG_READER *reader = new_planar_code_reader(in, &reader_options);
+    PG_WRITER *writer = new_plane_graph_writer(out, print_header);
+    PG_CERTIFICATE_SET *set = new_certificate_set(0);
+    PLANE_GRAPH *pg = new_plane_graph(100, 0);
+    //one workspace is reused for all graphs
+    PG_AUT_COMP_DATA *workspace = new_automorphism_computation_workspace();
+    
+    if(reader == NULL || writer == NULL || set == NULL || pg == NULL){
+        success = FALSE;
+    }
+    
+    while(success && read_and_decode_planar_code_into(reader, pg)){
+        read_count++;
+        if(add_graph_to_certificate_set_with_workspace(set, pg, workspace)){
+            success = write_planar_code_to_writer(writer, pg);
+            if(success){
+                written_count++;
+            }
+        }
+    }
+    
+    //the loop also ends when the input is truncated or invalid
+    if(reader != NULL && reader->error){
+        success = FALSE;
+    }
+    
+    if(read != NULL){
+        *read = read_count;
+    }
+    if(written != NULL){
+        *written = written_count;
+    }
+    
+    if(writer != NULL){
+        success = free_plane_graph_writer(writer) && success;
+    }
+    if(reader != NULL) free_planar_code_reader(reader);
+    if(set != NULL) free_certificate_set(set);
+    if(pg != NULL) free_plane_graph(pg);
+    free_automorphism_computation_workspace(workspace);
+    
+    return success;
+}
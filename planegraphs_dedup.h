@@ -0,0 +1,97 @@
+/*
+ * Main developer: Nico Van Cleemput
+ *
+ * Copyright (C) 2019 Nico Van Cleemput.
+ * Licensed under the GNU GPL, read the file LICENSE.txt for details.
+ */
+
+#ifndef PLANEGRAPH_DEDUP_H
+#define PLANEGRAPH_DEDUP_H
+
+#include "planegraphs_base.h"
+#include "planegraphs_input.h"
+#include "planegraphs_automorphismgroup.h"
+#include <stdio.h>
+#include <stdint.h>
+
+#ifdef	__cplusplus
+extern "C" {
+#endif
+
+    typedef struct __pg_certificate_set PG_CERTIFICATE_SET;
+    
+    /* A set of canonical forms. Only a 128 bit hash of each certificate is
+     * stored, so the set uses 16 bytes per graph (at a load factor of at most
+     * one half). Two different certificates are only considered equal when 
+     * their hashes collide, which is extremely unlikely.
+     */
+    struct __pg_certificate_set {
+        //two consecutive entries form a hash, and 0 0 marks an empty slot
+        uint64_t *hashes;
+        //the number of slots: always a power of two
+        size_t capacity;
+        size_t count;
+    };
+    
+    /**
+     * Creates a new empty set.
+     * 
+     * This function might return a NULL pointer if insufficient memory was
+     * available.
+     * 
+     * @param expected_size the expected number of canonical forms
+     */
+    PG_CERTIFICATE_SET *new_certificate_set(size_t expected_size);
+    
+    void free_certificate_set(PG_CERTIFICATE_SET *set);
+    
+    /**
+     * Adds the canonical form to the set.
+     * @param set
+     * @param form
+     * @return TRUE if the set did not yet contain this canonical form
+     */
+    boolean add_canonical_form_to_certificate_set(PG_CERTIFICATE_SET *set, PG_CANONICAL_FORM *form);
+    
+    /**
+     * Adds the canonical form of the graph to the set. The faces of the graph
+     * should be constructed; this function exits otherwise.
+     * @param set
+     * @param pg
+     * @return TRUE if the set did not yet contain a graph isomorphic to pg
+     */
+    boolean add_graph_to_certificate_set(PG_CERTIFICATE_SET *set, PLANE_GRAPH *pg);
+    
+    /**
+     * Adds the canonical form of the graph to the set, using the given
+     * workspace to determine the canonical form.
+     * @param set
+     * @param pg
+     * @param workspace a workspace created with new_automorphism_computation_workspace,
+     *        or NULL to use a temporary workspace
+     * @return TRUE if the set did not yet contain a graph isomorphic to pg
+     */
+    boolean add_graph_to_certificate_set_with_workspace(PG_CERTIFICATE_SET *set, PLANE_GRAPH *pg,
+                                                        PG_AUT_COMP_DATA *workspace);
+    
+    /**
+     * Copies all graphs in planar code from in to out, except the graphs that
+     * are isomorphic to a graph that was read before. Mirror images are 
+     * considered to be isomorphic.
+     * @param in
+     * @param out
+     * @param options the options used to read the graphs
+     * @param print_header Include the header for planar code
+     * @param read if not NULL, the number of graphs that were read is stored here
+     * @param written if not NULL, the number of graphs that were written is stored here
+     * @return FALSE if the input could not be read completely or the output
+     *         could not be written
+     */
+    boolean remove_isomorphic_copies(FILE *in, FILE *out, PG_INPUT_OPTIONS *options, boolean print_header,
+                                     unsigned long long *read, unsigned long long *written);
+
+#ifdef	__cplusplus
+}
+#endif
+
+#endif //PLANEGRAPH_DEDUP_H
@@ -9,68 +9,303 @@
 #include <stdlib.h>
 #include <string.h>
 
-PLANE_GRAPH *decode_planar_code(unsigned short* code, PG_INPUT_OPTIONS *options) {
-    int i, j, code_position, nv, maxn;
-    int edge_counter = 0;
-    PG_EDGE *inverse;
+/**
+ * Returns the entry at the given position in the body of a planar code. Each
+ * entry is stored in width bytes (1 or the size of an unsigned short).
+ */
+static inline int code_entry(const unsigned char *entries, int width, size_t position){
+    if(width == 1){
+        return entries[position];
+    } else {
+        unsigned short entry;
+        memcpy(&entry, entries + position * sizeof(unsigned short), sizeof(unsigned short));
+        return entry;
+    }
+}
 
-    nv = code[0];
-    code_position = 1;
+/**
+ * Decodes the body of a planar code, i.e., the code without the leading
+ * number of vertices, into an existing graph. The arrays of the graph are
+ * only reallocated when they are too small for this graph. The inverse edges
+ * are paired in linear time.
+ * @param pg
+ * @param entries the first byte of the body
+ * @param width the number of bytes used for each entry
+ * @param nv the number of vertices
+ * @param options
+ * @return FALSE if insufficient memory was available or the code is not a
+ *         valid planar code
+ */
+static boolean decode_planar_code_body_into(PLANE_GRAPH *pg, const unsigned char *entries, int width, int nv,
+                                            PG_INPUT_OPTIONS *options) {
+    int i, j, neighbour, maxn, maxe, zero_counter, pending_count;
+    size_t code_position;
+    int edge_counter = 0;
+    PG_EDGE *e, *inverse;
     
     if(options->maxn <= 0){
         maxn = nv*options->maxnFactor;
     } else {
         maxn = options->maxn;
     }
+    if(maxn < nv){
+        maxn = nv;
+    }
     
-    PLANE_GRAPH *pg = new_plane_graph(maxn, options->maxe);
-    pg->nv = nv;
+    //determine the number of oriented edges
+    code_position = 0;
+    zero_counter = 0;
+    while(zero_counter < nv){
+        if(code_entry(entries, width, code_position++) == 0) zero_counter++;
+    }
+    
+    maxe = options->maxe;
+    if(maxe <= 0){
+        maxe = 6*maxn-12;
+    }
+    if(maxe < (int)code_position - nv){
+        maxe = (int)code_position - nv;
+    }
+    
+    if(!reset_plane_graph(pg, maxn, maxe)){
+        return FALSE;
+    }
+    
+    /* The inverse edges are paired in a single pass. Before vertex v is 
+     * decoded, first_edge[v] is the head of a list of all edges u->v with u<v
+     * (linked through their inverse field). When v is decoded, this list is 
+     * split into a list of pending edges for each u (the index of the head is
+     * stored in the index field of first_edge[u]). The edges v->u with u<v
+     * are then paired with the pending edges of u.
+     */
+    for (i = 0; i < nv; i++) {
+        pg->first_edge[i] = NULL;
+    }
+    pending_count = 0;
 
+    code_position = 0;
     for (i = 0; i < nv; i++) {
-        pg->degree[i] = 0;
+        //distribute the edges towards i over the pending lists of their start
+        e = pg->first_edge[i];
+        while(e != NULL){
+            PG_EDGE *next_e = e->inverse;
+            PG_EDGE *start_first_edge = pg->first_edge[e->start];
+            e->inverse = start_first_edge->index < 0 ? NULL : pg->edges + start_first_edge->index;
+            start_first_edge->index = e - pg->edges;
+            pending_count++;
+            e = next_e;
+        }
+        
+        if(code_entry(entries, width, code_position) == 0){
+            fprintf(stderr, "Invalid planar code: vertex %d has no neighbours.\n", i);
+            return FALSE;
+        }
         pg->first_edge[i] = pg->edges + edge_counter;
-        pg->edges[edge_counter].start = i;
-        pg->edges[edge_counter].end = code[code_position] - 1;
-        pg->edges[edge_counter].next = pg->edges + edge_counter + 1;
-        if (code[code_position] - 1 < i) {
-            inverse = find_edge(pg, code[code_position] - 1, i);
-            pg->edges[edge_counter].inverse = inverse;
-            inverse->inverse = pg->edges + edge_counter;
-        } else {
-            pg->edges[edge_counter].inverse = NULL;
-        }
-        edge_counter++;
-        code_position++;
-        for (j = 1; code[code_position]; j++, code_position++) {
-            pg->edges[edge_counter].start = i;
-            pg->edges[edge_counter].end = code[code_position] - 1;
-            pg->edges[edge_counter].prev = pg->edges + edge_counter - 1;
-            pg->edges[edge_counter].next = pg->edges + edge_counter + 1;
-            if (code[code_position] - 1 < i) {
-                inverse = find_edge(pg, code[code_position] - 1, i);
-                pg->edges[edge_counter].inverse = inverse;
-                inverse->inverse = pg->edges + edge_counter;
+        pg->first_edge[i]->index = -1;
+        for (j = 0; (neighbour = code_entry(entries, width, code_position) - 1) >= 0; j++, code_position++) {
+            if(neighbour >= nv || neighbour == i){
+                fprintf(stderr, "Invalid planar code: illegal neighbour %d of vertex %d.\n", neighbour, i);
+                return FALSE;
+            }
+            e = pg->edges + edge_counter;
+            e->start = i;
+            e->end = neighbour;
+            if(j > 0){
+                e->prev = e - 1;
+            }
+            e->next = e + 1;
+            if (neighbour < i) {
+                PG_EDGE *neighbour_first_edge = pg->first_edge[neighbour];
+                if(neighbour_first_edge->index < 0){
+                    fprintf(stderr, "Invalid planar code: no edge from %d to %d.\n", neighbour, i);
+                    return FALSE;
+                }
+                inverse = pg->edges + neighbour_first_edge->index;
+                neighbour_first_edge->index = inverse->inverse == NULL ? -1 : inverse->inverse - pg->edges;
+                pending_count--;
+                e->inverse = inverse;
+                inverse->inverse = e;
             } else {
-                pg->edges[edge_counter].inverse = NULL;
+                //prepend to the list of edges towards neighbour
+                e->inverse = pg->first_edge[neighbour];
+                pg->first_edge[neighbour] = e;
             }
             edge_counter++;
         }
+        if(pending_count){
+            fprintf(stderr, "Invalid planar code: missing edges towards %d.\n", i);
+            return FALSE;
+        }
         pg->first_edge[i]->prev = pg->edges + edge_counter - 1;
         pg->edges[edge_counter - 1].next = pg->first_edge[i];
         pg->degree[i] = j;
 
         code_position++; /* read the closing 0 */
     }
+    pg->nv = nv;
 
     pg->ne = edge_counter;
+    //the number of vertices in front of the body is counted as well
+    PG_STATS_ADD(PG_STATS_DECODED_BYTES, (code_position + 1) * width);
 
     if(options->construct_faces){
         construct_faces(pg);
     }
     
+    return TRUE;
+}
+
+/**
+ * Decodes the body of a planar code into the given graph, and records the time
+ * this takes if the library is instrumented.
+ */
+static boolean decode_planar_code_entries_into(PLANE_GRAPH *pg, const unsigned char *entries, int width, int nv,
+                                               PG_INPUT_OPTIONS *options) {
+    PG_STATS_START(PG_STATS_PHASE_DECODE);
+    boolean result = decode_planar_code_body_into(pg, entries, width, nv, options);
+    PG_STATS_STOP(PG_STATS_PHASE_DECODE);
+    return result;
+}
+
+/**
+ * Decodes the body of a planar code into a newly allocated graph.
+ */
+static PLANE_GRAPH *decode_planar_code_entries(const unsigned char *entries, int width, int nv, PG_INPUT_OPTIONS *options) {
+    int maxn;
+    
+    if(options->maxn <= 0){
+        maxn = nv*options->maxnFactor;
+    } else {
+        maxn = options->maxn;
+    }
+    
+    PLANE_GRAPH *pg = new_plane_graph(maxn, options->maxe);
+    if(pg == NULL){
+        return NULL;
+    }
+    
+    if(!decode_planar_code_entries_into(pg, entries, width, nv, options)){
+        free_plane_graph(pg);
+        return NULL;
+    }
+    
     return pg;
 }
 
+PLANE_GRAPH *decode_planar_code(unsigned short* code, PG_INPUT_OPTIONS *options) {
+    return decode_planar_code_entries((const unsigned char *)(code + 1), sizeof(unsigned short), code[0], options);
+}
+
+/**
+ * Decodes the planar code into an existing graph. The graph is emptied first
+ * and its arrays are only reallocated when they are too small for this code.
+ * @param pg
+ * @param code
+ * @param options
+ * @return FALSE if insufficient memory was available or the code is not a
+ *         valid planar code
+ */
+boolean decode_planar_code_into(PLANE_GRAPH *pg, unsigned short* code, PG_INPUT_OPTIONS *options) {
+    return decode_planar_code_entries_into(pg, (const unsigned char *)(code + 1), sizeof(unsigned short), code[0], options);
+}
+
+/**
+ * Determines the number of bytes used by the planar code that starts at the
+ * given position. The code is either stored with one byte per entry, or (if
+ * the first byte is 0) with an unsigned short per entry.
+ * @param data
+ * @param size the number of bytes available at data
+ * @return the length of the code in bytes, or 0 if data does not contain a 
+ *         complete code
+ */
+size_t planar_code_length(const unsigned char *data, size_t size){
+    int nv, zero_counter;
+    size_t position;
+    
+    if(size == 0){
+        return 0;
+    }
+    
+    zero_counter = 0;
+    if(data[0] != 0){
+        nv = data[0];
+        position = 1;
+        while(zero_counter < nv){
+            const unsigned char *zero = memchr(data + position, 0, size - position);
+            if(zero == NULL){
+                return 0;
+            }
+            position = zero - data + 1;
+            zero_counter++;
+        }
+    } else {
+        if(size < 1 + sizeof(unsigned short)){
+            return 0;
+        }
+        nv = code_entry(data + 1, sizeof(unsigned short), 0);
+        position = 1 + sizeof(unsigned short);
+        while(zero_counter < nv){
+            if(position + sizeof(unsigned short) > size){
+                return 0;
+            }
+            if(code_entry(data + position, sizeof(unsigned short), 0) == 0) zero_counter++;
+            position += sizeof(unsigned short);
+        }
+    }
+    
+    return position;
+}
+
+/**
+ * Decodes the planar code that starts at the given position directly from
+ * memory, i.e., without first copying it to an array of unsigned shorts.
+ * @param data
+ * @param size the number of bytes available at data
+ * @param consumed if not NULL, the number of bytes used by the code is stored here
+ * @param options
+ * @return the decoded graph, or NULL if data does not contain a complete code
+ */
+PLANE_GRAPH *decode_planar_code_bytes(const unsigned char *data, size_t size, size_t *consumed, PG_INPUT_OPTIONS *options){
+    size_t length = planar_code_length(data, size);
+    
+    if(length == 0){
+        fprintf(stderr, "Incomplete planar code.\n");
+        return NULL;
+    }
+    
+    if(consumed != NULL){
+        *consumed = length;
+    }
+    
+    if(data[0] != 0){
+        return decode_planar_code_entries(data + 1, 1, data[0], options);
+    } else {
+        return decode_planar_code_entries(data + 1 + sizeof(unsigned short), sizeof(unsigned short),
+                                          code_entry(data + 1, sizeof(unsigned short), 0), options);
+    }
+}
+
+boolean decode_planar_code_bytes_into(PLANE_GRAPH *pg, const unsigned char *data, size_t size, size_t *consumed,
+                                      PG_INPUT_OPTIONS *options){
+    size_t length = planar_code_length(data, size);
+    
+    if(length == 0){
+        fprintf(stderr, "Incomplete planar code.\n");
+        return FALSE;
+    }
+    
+    if(consumed != NULL){
+        *consumed = length;
+    }
+    
+    if(data[0] != 0){
+        return decode_planar_code_entries_into(pg, data + 1, 1, data[0], options);
+    } else {
+        return decode_planar_code_entries_into(pg, data + 1 + sizeof(unsigned short), sizeof(unsigned short),
+                                               code_entry(data + 1, sizeof(unsigned short), 0), options);
+    }
+}
+
 /**
  *
  * @param file
@@ -238,3 +473,664 @@ PLANE_GRAPH *read_and_decode_planar_code(FILE *f, PG_INPUT_OPTIONS *options){
     free(code);
     return pg;
 }
+
+//----------------READER--------------------
+
+PG_READER *new_planar_code_reader(FILE *file, PG_INPUT_OPTIONS *options){
+    PG_READER *reader = (PG_READER *)malloc(sizeof(PG_READER));
+    
+    if(reader == NULL){
+        fprintf(stderr, "Insufficient memory for reader.\n");
+        return NULL;
+    }
+    
+    reader->buffer = (unsigned char *)malloc(PG_READER_BUFFER_SIZE);
+    
+    if(reader->buffer == NULL){
+        fprintf(stderr, "Insufficient memory for reader buffer.\n");
+        free(reader);
+        return NULL;
+    }
+    
+    reader->code_length = options->initial_code_length < 2 ? 2 : options->initial_code_length;
+    reader->code = (unsigned short *)malloc(reader->code_length * sizeof(unsigned short));
+    
+    if(reader->code == NULL){
+        fprintf(stderr, "Insufficient memory to store code for this graph.\n");
+        free(reader->buffer);
+        free(reader);
+        return NULL;
+    }
+    
+    reader->file = file;
+    reader->options = *options;
+    reader->first = TRUE;
+    reader->error = FALSE;
+    reader->buffer_size = PG_READER_BUFFER_SIZE;
+    reader->position = 0;
+    reader->length = 0;
+    
+    return reader;
+}
+
+void free_planar_code_reader(PG_READER *reader){
+    free(reader->code);
+    free(reader->buffer);
+    free(reader);
+}
+
+/**
+ * Makes sure that at least needed unread bytes are available in the buffer
+ * of the reader. The unread bytes are moved to the front of the buffer before
+ * the buffer is refilled.
+ * @param reader
+ * @param needed
+ * @return FALSE if the end of the file was reached before needed bytes were available
+ */
+static boolean fill_reader_buffer(PG_READER *reader, size_t needed){
+    size_t available = reader->length - reader->position;
+    
+    if(available >= needed){
+        return TRUE;
+    }
+    
+    if(reader->position > 0){
+        memmove(reader->buffer, reader->buffer + reader->position, available);
+        reader->position = 0;
+        reader->length = available;
+    }
+    
+    while(reader->length < needed){
+        size_t read_count = fread(reader->buffer + reader->length, sizeof(unsigned char),
+                                  reader->buffer_size - reader->length, reader->file);
+        if(read_count == 0){
+            return FALSE;
+        }
+        reader->length += read_count;
+    }
+    
+    return TRUE;
+}
+
+/**
+ * Skips a header in the buffer of the reader. The header is closed by <<.
+ * @param reader
+ * @return FALSE if the header is not correctly closed
+ */
+static boolean skip_header(PG_READER *reader){
+    //look for the first <
+    do {
+        if(!fill_reader_buffer(reader, 1)){
+            return FALSE;
+        }
+    } while(reader->buffer[reader->position++] != '<');
+    
+    //read one more character (header is closed by <<)
+    if(!fill_reader_buffer(reader, 1)){
+        return FALSE;
+    }
+    if(reader->buffer[reader->position++] != '<'){
+        fprintf(stderr, "Problems with header -- single '<'\n");
+        return FALSE;
+    }
+    
+    return TRUE;
+}
+
+/**
+ * Doubles the size of the code buffer of the reader.
+ * @param reader
+ * @return FALSE if insufficient memory was available
+ */
+static boolean grow_code_buffer(PG_READER *reader){
+    int new_code_length = 2 * reader->code_length;
+    unsigned short* new_code = realloc(reader->code, new_code_length * sizeof(unsigned short));
+    if(new_code == NULL){
+        fprintf(stderr, "Insufficient memory to store code for this graph.\n");
+        return FALSE;
+    }
+    reader->code = new_code;
+    reader->code_length = new_code_length;
+    return TRUE;
+}
+
+/**
+ * Called when no bytes are left in the file before the start of a code. This
+ * is the end of the stream, unless the file could not be read.
+ * @param reader
+ * @return 0
+ */
+static int end_of_stream(PG_READER *reader){
+    if(ferror(reader->file)){
+        fprintf(stderr, "Could not read from file.\n");
+        reader->error = TRUE;
+    }
+    return 0;
+}
+
+/**
+ * Reads the next planar code from the reader into the code buffer of the
+ * reader. The buffer is reused for each code and only grows when needed.
+ * @param reader
+ * @return the number of entries in the code, or 0 if the end of the stream
+ *         was reached or an error occurred (in which case reader->error is set)
+ */
+int read_planar_code_into_reader_buffer(PG_READER *reader){
+    int buffer_size, zero_counter, nv;
+    unsigned short entry;
+    const unsigned char *current, *end;
+    
+    if(reader->error){
+        return 0;
+    }
+    
+    if(reader->first){
+        reader->first = FALSE;
+        
+        if(reader->options.contains_header){
+            //we check that there is a header
+            if(!fill_reader_buffer(reader, 13)){
+                fprintf(stderr, "can't read header: file too small.\n");
+                reader->error = TRUE;
+                return 0;
+            }
+            if(memcmp(reader->buffer + reader->position, ">>planar_code", 13) != 0){
+                fprintf(stderr, "No planarcode header detected.\n");
+                reader->error = TRUE;
+                return 0;
+            }
+            reader->position += 13;
+            
+            //skip reminder of header (either empty or le/be specification)
+            if(!skip_header(reader)){
+                fprintf(stderr, "Invalid formatted header.\n");
+                reader->error = TRUE;
+                return 0;
+            }
+        }
+    }
+    
+    if(!fill_reader_buffer(reader, 1)){
+        //nothing left in file
+        return end_of_stream(reader);
+    }
+    
+    /* possibly removing interior headers */
+    if(reader->options.remove_internal_headers && reader->buffer[reader->position] == '>'){
+        // could be a header, or maybe just a 62 (which is also possible for unsigned char)
+        if(fill_reader_buffer(reader, 3) &&
+                reader->buffer[reader->position + 1] == '>' &&
+                reader->buffer[reader->position + 2] == 'p'){
+            /*we are sure that we're dealing with a header*/
+            reader->position += 3;
+            if(!skip_header(reader)){
+                reader->error = TRUE;
+                return 0;
+            }
+            if(!fill_reader_buffer(reader, 1)){
+                //nothing left in file
+                return end_of_stream(reader);
+            }
+        }
+    }
+    
+    unsigned short *code = reader->code;
+    zero_counter = 0;
+    
+    //start reading the graph
+    if(reader->buffer[reader->position] != 0){
+        nv = code[0] = reader->buffer[reader->position++];
+        buffer_size = 1;
+        while(zero_counter < nv){
+            if(!fill_reader_buffer(reader, 1)){
+                fprintf(stderr, "Unexpected EOF.\n");
+                reader->error = TRUE;
+                return 0;
+            }
+            current = reader->buffer + reader->position;
+            end = reader->buffer + reader->length;
+            while(current < end && zero_counter < nv){
+                if(buffer_size == reader->code_length){
+                    if(!grow_code_buffer(reader)){
+                        reader->error = TRUE;
+                        return 0;
+                    }
+                    code = reader->code;
+                }
+                entry = *current++;
+                code[buffer_size++] = entry;
+                if(entry == 0) zero_counter++;
+            }
+            reader->position = current - reader->buffer;
+        }
+    } else {
+        reader->position++;
+        if(!fill_reader_buffer(reader, sizeof(unsigned short))){
+            fprintf(stderr, "Unexpected EOF.\n");
+            reader->error = TRUE;
+            return 0;
+        }
+        memcpy(code, reader->buffer + reader->position, sizeof(unsigned short));
+        reader->position += sizeof(unsigned short);
+        nv = code[0];
+        buffer_size = 1;
+        while(zero_counter < nv){
+            if(!fill_reader_buffer(reader, sizeof(unsigned short))){
+                fprintf(stderr, "Unexpected EOF.\n");
+                reader->error = TRUE;
+                return 0;
+            }
+            current = reader->buffer + reader->position;
+            end = reader->buffer + reader->length;
+            while(current + sizeof(unsigned short) <= end && zero_counter < nv){
+                if(buffer_size == reader->code_length){
+                    if(!grow_code_buffer(reader)){
+                        reader->error = TRUE;
+                        return 0;
+                    }
+                    code = reader->code;
+                }
+                memcpy(&entry, current, sizeof(unsigned short));
+                current += sizeof(unsigned short);
+                code[buffer_size++] = entry;
+                if(entry == 0) zero_counter++;
+            }
+            reader->position = current - reader->buffer;
+        }
+    }
+    
+    return buffer_size;
+}
+
+/**
+ * Reads the next planar code from the reader. The code is stored in the
+ * same way as by read_planar_code, and should be freed by the caller.
+ * @param reader
+ * @return the next code, or NULL if the end of the stream was reached or
+ *         an error occurred
+ */
+unsigned short *read_planar_code_from_reader(PG_READER *reader){
+    int code_size = read_planar_code_into_reader_buffer(reader);
+    if(code_size == 0){
+        return NULL;
+    }
+    unsigned short* code = malloc(code_size * sizeof(unsigned short));
+    if(code == NULL){
+        fprintf(stderr, "Insufficient memory to store code for this graph.\n");
+        reader->error = TRUE;
+        return NULL;
+    }
+    memcpy(code, reader->code, code_size * sizeof(unsigned short));
+    return code;
+}
+
+
+PLANE_GRAPH *read_and_decode_planar_code_from_reader(PG_READER *reader){
+    if(!read_planar_code_into_reader_buffer(reader)){
+        return NULL;
+    }
+    PLANE_GRAPH *pg = decode_planar_code(reader->code, &(reader->options));
+    if(pg == NULL){
+        reader->error = TRUE;
+    }
+    return pg;
+}
+
+/**
+ * Reads the next planar code from the reader and decodes it into an existing
+ * graph. Neither the code nor the graph are allocated for each graph, so this
+ * is the preferred way to process a large number of graphs.
+ * @param reader
+ * @param pg
+ * @return FALSE if the end of the stream was reached or an error occurred
+ *         (in which case reader->error is set)
+ */
+boolean read_and_decode_planar_code_into(PG_READER *reader, PLANE_GRAPH *pg){
+    if(!read_planar_code_into_reader_buffer(reader)){
+        return FALSE;
+    }
+    if(!decode_planar_code_into(pg, reader->code, &(reader->options))){
+        reader->error = TRUE;
+        return FALSE;
+    }
+    return TRUE;
+}
+
+//----------------COMPRESSED PLANAR CODE--------------------
+
+PG_COMPRESSED_READER *new_compressed_planar_code_reader(FILE *file, PG_INPUT_OPTIONS *options){
+    PG_COMPRESSED_READER *reader = (PG_COMPRESSED_READER *)malloc(sizeof(PG_COMPRESSED_READER));
+    
+    if(reader == NULL){
+        fprintf(stderr, "Insufficient memory for reader.\n");
+        return NULL;
+    }
+    
+    reader->code_length = options->initial_code_length < 2 ? 2 : options->initial_code_length;
+    reader->code = (unsigned short *)malloc(reader->code_length * sizeof(unsigned short));
+    
+    if(reader->code == NULL){
+        fprintf(stderr, "Insufficient memory to store code for this graph.\n");
+        free(reader);
+        return NULL;
+    }
+    
+    reader->file = file;
+    reader->options = *options;
+    reader->first = TRUE;
+    reader->block = NULL;
+    reader->block_length = reader->block_allocated = reader->position = 0;
+    reader->remaining = 0;
+    reader->finished = FALSE;
+    reader->error = FALSE;
+    reader->block_count = reader->graph_count = 0;
+    reader->block_offsets = reader->block_first_graphs = NULL;
+    
+    return reader;
+}
+
+void free_compressed_planar_code_reader(PG_COMPRESSED_READER *reader){
+    free(reader->block);
+    free(reader->block_offsets);
+    free(reader->block_first_graphs);
+    free(reader->code);
+    free(reader);
+}
+
+static uint64_t load_uint64(const unsigned char *bytes){
+    uint64_t value = 0;
+    for(int i = 7; i >= 0; i--){
+        value = (value << 8) | bytes[i];
+    }
+    return value;
+}
+
+/**
+ * Reads a variable length integer from the file.
+ * @return FALSE if the end of the file was reached or the integer is too long
+ */
+static boolean read_varint(FILE *file, uint64_t *value){
+    int c, shift = 0;
+    *value = 0;
+    do {
+        if((c = fgetc(file)) == EOF || shift > 63){
+            return FALSE;
+        }
+        *value |= (uint64_t)(c & 0x7F) << shift;
+        shift += 7;
+    } while(c & 0x80);
+    return TRUE;
+}
+
+/**
+ * Reads a variable length integer from memory, and moves position past it.
+ * @return FALSE if the integer does not end before end
+ */
+static inline boolean load_varint(const unsigned char **position, const unsigned char *end, uint64_t *value){
+    int shift = 0;
+    const unsigned char *current = *position;
+    *value = 0;
+    do {
+        if(current == end || shift > 63){
+            return FALSE;
+        }
+        *value |= (uint64_t)(*current & 0x7F) << shift;
+        shift += 7;
+    } while(*current++ & 0x80);
+    *position = current;
+    return TRUE;
+}
+
+boolean load_compressed_planar_code_index(PG_COMPRESSED_READER *reader){
+    unsigned char trailer[PG_COMPRESSED_TRAILER_SIZE];
+    boolean success = FALSE;
+    
+    off_t current_position = ftello(reader->file);
+    if(current_position < 0 || fseeko(reader->file, -PG_COMPRESSED_TRAILER_SIZE, SEEK_END) ||
+            fread(trailer, 1, PG_COMPRESSED_TRAILER_SIZE, reader->file) != PG_COMPRESSED_TRAILER_SIZE ||
+            memcmp(trailer + 24, PG_COMPRESSED_TRAILER, 8) != 0){
+        fprintf(stderr, "No compressed planar code index detected.\n");
+        fseeko(reader->file, current_position, SEEK_SET);
+        return FALSE;
+    }
+    
+    uint64_t index_offset = load_uint64(trailer);
+    uint64_t block_count = load_uint64(trailer + 8);
+    
+    //each block takes at least 3 bytes
+    if(block_count > index_offset / 3){
+        fprintf(stderr, "Invalid compressed planar code index.\n");
+        fseeko(reader->file, current_position, SEEK_SET);
+        return FALSE;
+    }
+    
+    unsigned char *index = (unsigned char *)malloc(16 * block_count + 1);
+    uint64_t *block_offsets = (uint64_t *)malloc(sizeof(uint64_t) * (block_count + 1));
+    uint64_t *block_first_graphs = (uint64_t *)malloc(sizeof(uint64_t) * (block_count + 1));
+    
+    if(index == NULL || block_offsets == NULL || block_first_graphs == NULL){
+        fprintf(stderr, "Insufficient memory for index.\n");
+    } else if(fseeko(reader->file, (off_t)index_offset, SEEK_SET) ||
+            fread(index, 16, block_count, reader->file) != block_count){
+        fprintf(stderr, "Could not read compressed planar code index.\n");
+    } else {
+        for(uint64_t i = 0; i < block_count; i++){
+            block_offsets[i] = load_uint64(index + 16*i);
+            block_first_graphs[i] = load_uint64(index + 16*i + 8);
+        }
+        //a sentinel makes it easier to determine the number of graphs in a block
+        block_offsets[block_count] = index_offset - 1;
+        block_first_graphs[block_count] = load_uint64(trailer + 16);
+        
+        free(reader->block_offsets);
+        free(reader->block_first_graphs);
+        reader->block_offsets = block_offsets;
+        reader->block_first_graphs = block_first_graphs;
+        reader->block_count = block_count;
+        reader->graph_count = block_first_graphs[block_count];
+        block_offsets = block_first_graphs = NULL;
+        success = TRUE;
+    }
+    
+    free(index);
+    free(block_offsets);
+    free(block_first_graphs);
+    fseeko(reader->file, current_position, SEEK_SET);
+    
+    return success;
+}
+
+boolean seek_compressed_planar_code_block(PG_COMPRESSED_READER *reader, uint64_t block){
+    if(reader->block_offsets == NULL || block >= reader->block_count){
+        fprintf(stderr, "Block %llu does not exist.\n", (unsigned long long) block);
+        return FALSE;
+    }
+    if(fseeko(reader->file, (off_t)reader->block_offsets[block], SEEK_SET)){
+        fprintf(stderr, "Could not seek to block %llu.\n", (unsigned long long) block);
+        return FALSE;
+    }
+    
+    reader->first = FALSE;
+    reader->remaining = 0;
+    reader->finished = FALSE;
+    reader->error = FALSE;
+    
+    return TRUE;
+}
+
+boolean seek_compressed_planar_code_graph(PG_COMPRESSED_READER *reader, uint64_t graph){
+    if(reader->block_offsets == NULL || graph >= reader->graph_count){
+        fprintf(stderr, "Graph %llu does not exist.\n", (unsigned long long) graph);
+        return FALSE;
+    }
+    
+    //find the last block that starts at or before this graph
+    uint64_t low = 0, high = reader->block_count - 1;
+    while(low < high){
+        uint64_t middle = (low + high + 1) / 2;
+        if(reader->block_first_graphs[middle] <= graph){
+            low = middle;
+        } else {
+            high = middle - 1;
+        }
+    }
+    
+    if(!seek_compressed_planar_code_block(reader, low)){
+        return FALSE;
+    }
+    for(uint64_t i = reader->block_first_graphs[low]; i < graph; i++){
+        if(!read_compressed_planar_code_into_reader_buffer(reader)){
+            return FALSE;
+        }
+    }
+    
+    return TRUE;
+}
+
+/**
+ * Reads the next block from the file into the block buffer of the reader.
+ * @return FALSE if there are no more blocks or an error occurred
+ */
+static boolean read_compressed_block(PG_COMPRESSED_READER *reader){
+    uint64_t graph_count, length;
+    
+    if(!read_varint(reader->file, &graph_count)){
+        fprintf(stderr, "Unexpected EOF.\n");
+        reader->error = TRUE;
+        return FALSE;
+    }
+    if(graph_count == 0){
+        reader->finished = TRUE;
+        return FALSE;
+    }
+    if(!read_varint(reader->file, &length) || length > SIZE_MAX){
+        fprintf(stderr, "Unexpected EOF.\n");
+        reader->error = TRUE;
+        return FALSE;
+    }
+    
+    if(length > reader->block_allocated){
+        unsigned char *new_block = (unsigned char *)realloc(reader->block, length);
+        if(new_block == NULL){
+            fprintf(stderr, "Insufficient memory for block.\n");
+            reader->error = TRUE;
+            return FALSE;
+        }
+        reader->block = new_block;
+        reader->block_allocated = length;
+    }
+    
+    if(fread(reader->block, 1, length, reader->file) != length){
+        fprintf(stderr, "Unexpected EOF.\n");
+        reader->error = TRUE;
+        return FALSE;
+    }
+    
+    reader->block_length = length;
+    reader->position = 0;
+    reader->remaining = graph_count;
+    
+    return TRUE;
+}
+
+int read_compressed_planar_code_into_reader_buffer(PG_COMPRESSED_READER *reader){
+    uint64_t nv, degree, difference;
+    int buffer_size;
+    
+    if(reader->error){
+        return 0;
+    }
+    
+    if(reader->first){
+        char header[sizeof(PG_COMPRESSED_HEADER) - 1];
+        reader->first = FALSE;
+        if(fread(header, 1, sizeof(header), reader->file) != sizeof(header) ||
+                memcmp(header, PG_COMPRESSED_HEADER, sizeof(header)) != 0){
+            fprintf(stderr, "No compressed planar code header detected.\n");
+            reader->error = TRUE;
+            return 0;
+        }
+    }
+    
+    if(reader->remaining == 0){
+        if(reader->finished || !read_compressed_block(reader)){
+            return 0;
+        }
+    }
+    
+    const unsigned char *position = reader->block + reader->position;
+    const unsigned char *end = reader->block + reader->block_length;
+    
+    if(!load_varint(&position, end, &nv) || nv == 0 || nv >= 65535){
+        fprintf(stderr, "Invalid compressed planar code.\n");
+        reader->error = TRUE;
+        return 0;
+    }
+    
+    unsigned short *code = reader->code;
+    code[0] = nv;
+    buffer_size = 1;
+    for(int v = 0; v < (int)nv; v++){
+        if(!load_varint(&position, end, &degree) || degree == 0 || degree > (uint64_t)(end - position)){
+            fprintf(stderr, "Invalid compressed planar code.\n");
+            reader->error = TRUE;
+            return 0;
+        }
+        while(buffer_size + (int)degree + 1 > reader->code_length){
+            int new_code_length = 2 * reader->code_length;
+            unsigned short* new_code = realloc(reader->code, new_code_length * sizeof(unsigned short));
+            if(new_code == NULL){
+                fprintf(stderr, "Insufficient memory to store code for this graph.\n");
+                reader->error = TRUE;
+                return 0;
+            }
+            reader->code = code = new_code;
+            reader->code_length = new_code_length;
+        }
+        int previous = v;
+        for(uint64_t j = 0; j < degree; j++){
+            if(!load_varint(&position, end, &difference)){
+                fprintf(stderr, "Invalid compressed planar code.\n");
+                reader->error = TRUE;
+                return 0;
+            }
+            int64_t neighbour = (difference & 1) ? 
+                previous - (int64_t)((difference + 1) >> 1) : previous + (int64_t)(difference >> 1);
+            if(neighbour < 0 || neighbour >= (int64_t)nv){
+                fprintf(stderr, "Invalid compressed planar code.\n");
+                reader->error = TRUE;
+                return 0;
+            }
+            code[buffer_size++] = neighbour + 1;
+            previous = neighbour;
+        }
+        code[buffer_size++] = 0;
+    }
+    
+    reader->position = position - reader->block;
+    reader->remaining--;
+    
+    return buffer_size;
+}
+
+PLANE_GRAPH *read_and_decode_compressed_planar_code(PG_COMPRESSED_READER *reader){
+    if(read_compressed_planar_code_into_reader_buffer(reader) == 0){
+        return NULL;
+    }
+    PLANE_GRAPH *pg = decode_planar_code(reader->code, &(reader->options));
+    if(pg == NULL){
+        reader->error = TRUE;
+    }
+    return pg;
+}
+
+boolean read_and_decode_compressed_planar_code_into(PG_COMPRESSED_READER *reader, PLANE_GRAPH *pg){
+    if(read_compressed_planar_code_into_reader_buffer(reader) == 0){
+        return FALSE;
+    }
+    if(!decode_planar_code_into(pg, reader->code, &(reader->options))){
+        reader->error = TRUE;
+        return FALSE;
+    }
+    return TRUE;
+}
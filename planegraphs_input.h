@@ -10,6 +10,7 @@
 
 #include "planegraphs_base.h"
 #include<stdio.h>
+#include<stdint.h>
 
 #ifdef	__cplusplus
 extern "C" {
@@ -33,11 +34,286 @@ extern "C" {
 //the default code length is sufficient to store any graph with less than 100 vertices
 #define DEFAULT_PG_INPUT_OPTIONS(options) PG_INPUT_OPTIONS options = {TRUE, TRUE, 700, 0, 1, 0, FALSE}
 
+    typedef struct __planar_code_reader PG_READER;
+    
+    /* A reader owns the header state of a single planar code stream and 
+     * buffers the underlying file in large blocks. Different readers are 
+     * independent of each other, so several files can be read at the same
+     * time (also from different threads, as long as each reader is only
+     * used by one thread at a time).
+     */
+    struct __planar_code_reader {
+        FILE *file;
+        PG_INPUT_OPTIONS options;
+        
+        //TRUE as long as the header at the start of the stream has not been handled
+        boolean first;
+        
+        //TRUE if the stream could not be read, a code was truncated or invalid,
+        //or there was insufficient memory. No more codes are read after an error.
+        boolean error;
+        
+        unsigned char *buffer;
+        size_t buffer_size;
+        //the position of the first unread byte in the buffer
+        size_t position;
+        //the number of valid bytes in the buffer
+        size_t length;
+        
+        //the buffer in which the current code is stored
+        unsigned short *code;
+        int code_length;
+    };
+    
+//the size of the block in which the file is read by a PG_READER
+#define PG_READER_BUFFER_SIZE (1 << 20)
+
     PLANE_GRAPH *decode_planar_code(unsigned short* code, PG_INPUT_OPTIONS *options);
+    
+    /**
+     * Decodes the planar code into an existing graph. The graph is emptied first
+     * and its arrays are only reallocated when they are too small for this code.
+     * @param pg
+     * @param code
+     * @param options
+     * @return FALSE if insufficient memory was available or the code is not a
+     *         valid planar code
+     */
+    boolean decode_planar_code_into(PLANE_GRAPH *pg, unsigned short* code, PG_INPUT_OPTIONS *options);
+    
+    /**
+     * Determines the number of bytes used by the planar code that starts at the
+     * given position. The code is either stored with one byte per entry, or (if
+     * the first byte is 0) with an unsigned short per entry.
+     * @param data
+     * @param size the number of bytes available at data
+     * @return the length of the code in bytes, or 0 if data does not contain a 
+     *         complete code
+     */
+    size_t planar_code_length(const unsigned char *data, size_t size);
+    
+    /**
+     * Decodes the planar code that starts at the given position directly from
+     * memory, i.e., without first copying it to an array of unsigned shorts.
+     * @param data
+     * @param size the number of bytes available at data
+     * @param consumed if not NULL, the number of bytes used by the code is stored here
+     * @param options
+     * @return the decoded graph, or NULL if data does not contain a complete code
+     */
+    PLANE_GRAPH *decode_planar_code_bytes(const unsigned char *data, size_t size, size_t *consumed, PG_INPUT_OPTIONS *options);
+    
+    /**
+     * Decodes the planar code that starts at the given position directly from
+     * memory into an existing graph. This is the counterpart of 
+     * encode_planar_code.
+     * @param pg
+     * @param data
+     * @param size the number of bytes available at data
+     * @param consumed if not NULL, the number of bytes used by the code is stored here
+     * @param options
+     * @return FALSE if data does not contain a complete and valid code, or if
+     *         insufficient memory was available
+     */
+    boolean decode_planar_code_bytes_into(PLANE_GRAPH *pg, const unsigned char *data, size_t size, size_t *consumed,
+                                          PG_INPUT_OPTIONS *options);
 
+    /**
+     * Reads the next planar code from the file. This function keeps track of
+     * the header in a static variable, and can therefore only be used to read
+     * a single file per process. Use a PG_READER to read several files.
+     */
     unsigned short *read_planar_code(FILE *file, PG_INPUT_OPTIONS *options);
     
     PLANE_GRAPH *read_and_decode_planar_code(FILE *f, PG_INPUT_OPTIONS *options);
+    
+    /**
+     * Creates a new reader for the planar code stream in the given file. The
+     * options are copied into the reader. The reader does not take ownership
+     * of the file.
+     * 
+     * This function might return a NULL pointer if insufficient memory was
+     * available.
+     * 
+     * @param file
+     * @param options
+     */
+    PG_READER *new_planar_code_reader(FILE *file, PG_INPUT_OPTIONS *options);
+    
+    void free_planar_code_reader(PG_READER *reader);
+    
+    /**
+     * Reads the next planar code from the reader. The code is stored in the
+     * same way as by read_planar_code, and should be freed by the caller.
+     * @param reader
+     * @return the next code, or NULL if the end of the stream was reached or
+     *         an error occurred (in which case reader->error is set)
+     */
+    unsigned short *read_planar_code_from_reader(PG_READER *reader);
+    
+    /**
+     * Reads the next planar code from the reader into the code buffer of the
+     * reader (reader->code). The buffer is reused for each code and only 
+     * grows when needed, so the code is only valid until the next call.
+     * @param reader
+     * @return the number of entries in the code, or 0 if the end of the stream
+     *         was reached or an error occurred (in which case reader->error is set)
+     */
+    int read_planar_code_into_reader_buffer(PG_READER *reader);
+    
+    /**
+     * Reads the next planar code from the reader and decodes it into a new graph.
+     * @param reader
+     * @return the graph, or NULL if the end of the stream was reached or an error
+     *         occurred (in which case reader->error is set)
+     */
+    PLANE_GRAPH *read_and_decode_planar_code_from_reader(PG_READER *reader);
+    
+    /**
+     * Reads the next planar code from the reader and decodes it into an existing
+     * graph. Neither the code nor the graph are allocated for each graph, so this
+     * is the preferred way to process a large number of graphs.
+     * @param reader
+     * @param pg
+     * @return FALSE if the end of the stream was reached or an error occurred
+     *         (in which case reader->error is set)
+     */
+    boolean read_and_decode_planar_code_into(PG_READER *reader, PLANE_GRAPH *pg);
+
+    /* Compressed planar code
+     * 
+     * A file in compressed planar code starts with the header 
+     * >>compressed_planar_code<< which is followed by a number of blocks. Each
+     * block starts with the number of graphs in the block and the number of
+     * bytes used by those graphs. A block can be decoded independently of all
+     * other blocks. The last block is followed by a single 0 (i.e., a block
+     * without graphs) and by the index. The index contains for each block its
+     * offset in the file and the number of its first graph. The file ends with
+     * the offset of the index, the number of blocks, the number of graphs and
+     * the 8 bytes PGCINDEX. All these numbers are stored as 8 byte little endian
+     * integers.
+     * 
+     * All other numbers are stored as variable length integers: 7 bits per byte, 
+     * least significant bits first, and the highest bit is set in all bytes
+     * except the last one. A graph is stored as the number of vertices, followed
+     * for each vertex by its degree and its neighbours in clockwise order. The
+     * neighbours are stored as the difference with the previous neighbour (or 
+     * with the vertex itself for the first neighbour), where a difference d is
+     * stored as 2d if d >= 0 and as -2d-1 otherwise. Vertices are numbered
+     * starting from 0.
+     */
+    
+#define PG_COMPRESSED_HEADER ">>compressed_planar_code<<"
+#define PG_COMPRESSED_TRAILER "PGCINDEX"
+//the size of the trailer: offset of the index, number of blocks, number of graphs and PGCINDEX
+#define PG_COMPRESSED_TRAILER_SIZE 32
+//a block is finished as soon as it contains at least this number of bytes
+#define PG_COMPRESSED_BLOCK_SIZE (1 << 20)
+    
+    typedef struct __compressed_planar_code_reader PG_COMPRESSED_READER;
+    
+    struct __compressed_planar_code_reader {
+        FILE *file;
+        PG_INPUT_OPTIONS options;
+        
+        //TRUE as long as the header at the start of the file has not been handled
+        boolean first;
+        
+        //the current block
+        unsigned char *block;
+        size_t block_length;
+        size_t block_allocated;
+        size_t position;
+        //the number of graphs in the current block that have not been read
+        uint64_t remaining;
+        
+        //TRUE if the end of the blocks was reached
+        boolean finished;
+        //TRUE if the file is not valid compressed planar code, could not be read
+        //or contained a code that could not be decoded
+        boolean error;
+        
+        //the index: only available after a call to load_compressed_planar_code_index
+        uint64_t block_count;
+        uint64_t graph_count;
+        uint64_t *block_offsets;
+        uint64_t *block_first_graphs;
+        
+        //the buffer in which the current code is stored as planar code
+        unsigned short *code;
+        int code_length;
+    };
+    
+    /**
+     * Creates a new reader for the compressed planar code in the given file. 
+     * The options are copied into the reader and are used to decode the graphs.
+     * The reader does not take ownership of the file.
+     * 
+     * This function might return a NULL pointer if insufficient memory was
+     * available.
+     * 
+     * @param file
+     * @param options
+     */
+    PG_COMPRESSED_READER *new_compressed_planar_code_reader(FILE *file, PG_INPUT_OPTIONS *options);
+    
+    void free_compressed_planar_code_reader(PG_COMPRESSED_READER *reader);
+    
+    /**
+     * Reads the index at the end of the file. This requires that the file
+     * is seekable. The position in the file is not changed.
+     * @param reader
+     * @return FALSE if the index could not be read
+     */
+    boolean load_compressed_planar_code_index(PG_COMPRESSED_READER *reader);
+    
+    /**
+     * Continues reading at the start of the given block. Since blocks are
+     * independent, several readers (each with its own file handle) can read
+     * different blocks of the same file in different threads.
+     * @param reader
+     * @param block
+     * @return FALSE if the index is not loaded, the block does not exist or
+     *         the file could not be positioned
+     */
+    boolean seek_compressed_planar_code_block(PG_COMPRESSED_READER *reader, uint64_t block);
+    
+    /**
+     * Continues reading at the given graph (the first graph has number 0).
+     * @param reader
+     * @param graph
+     * @return FALSE if the index is not loaded or the graph does not exist
+     */
+    boolean seek_compressed_planar_code_graph(PG_COMPRESSED_READER *reader, uint64_t graph);
+    
+    /**
+     * Reads the next graph from the reader, and stores its planar code in the
+     * code buffer of the reader (reader->code). The buffer is reused for each
+     * code and only grows when needed, so the code is only valid until the 
+     * next call.
+     * @param reader
+     * @return the number of entries in the code, or 0 if the end of the file
+     *         was reached or an error occurred (in which case reader->error is set)
+     */
+    int read_compressed_planar_code_into_reader_buffer(PG_COMPRESSED_READER *reader);
+    
+    /**
+     * Reads the next graph from the reader and decodes it.
+     * @param reader
+     * @return the graph, or NULL if the end of the file was reached or an error
+     *         occurred (in which case reader->error is set)
+     */
+    PLANE_GRAPH *read_and_decode_compressed_planar_code(PG_COMPRESSED_READER *reader);
+    
+    /**
+     * Reads the next graph from the reader and decodes it into an existing 
+     * graph.
+     * @param reader
+     * @param pg
+     * @return FALSE if the end of the file was reached or an error occurred
+     *         (in which case reader->error is set)
+     */
+    boolean read_and_decode_compressed_planar_code_into(PG_COMPRESSED_READER *reader, PLANE_GRAPH *pg);
 
 #ifdef	__cplusplus
 }
@@ -0,0 +1,339 @@
+/*
+ * Main developer: Nico Van Cleemput
+ *
+ * Copyright (C) 2019 Nico Van Cleemput.
+ * Licensed under the GNU GPL, read the file LICENSE.txt for details.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "planegraphs_base.h"
+#include "planegraphs_mutation.h"
+
+/**
+ * Walks around the face that contains the given edge and stores the face
+ * number in each edge.
+ * @return the size of the face
+ */
+static int label_face(PG_EDGE *start, int face){
+    int size = 0;
+    PG_EDGE *e = start;
+    do {
+        e->right_face = face;
+        size++;
+        e = e->inverse->prev;
+    } while (e != start);
+    return size;
+}
+
+/**
+ * Returns a new edge at the end of the edge array.
+ */
+static PG_EDGE *new_edge(PLANE_GRAPH *pg, int start, int end){
+    PG_EDGE *e = pg->edges + pg->ne;
+    pg->ne++;
+    e->start = start;
+    e->end = end;
+    e->mark = 0;
+    e->label = NULL;
+    return e;
+}
+
+/**
+ * Inserts the edge e in the rotation at e->start directly after the edge after.
+ */
+static void insert_in_rotation(PLANE_GRAPH *pg, PG_EDGE *e, PG_EDGE *after){
+    e->prev = after;
+    e->next = after->next;
+    after->next->prev = e;
+    after->next = e;
+    pg->degree[e->start]++;
+}
+
+/**
+ * Removes the edge e from the rotation at e->start, which should contain
+ * at least one other edge.
+ */
+static void remove_from_rotation(PLANE_GRAPH *pg, PG_EDGE *e){
+    e->prev->next = e->next;
+    e->next->prev = e->prev;
+    if(pg->first_edge[e->start] == e){
+        pg->first_edge[e->start] = e->next;
+    }
+    pg->degree[e->start]--;
+}
+
+/**
+ * Frees the slot of an edge that is no longer used by moving the last edge
+ * into that slot.
+ */
+static void remove_edge_slot(PLANE_GRAPH *pg, PG_EDGE *e){
+    PG_EDGE *last = pg->edges + pg->ne - 1;
+    pg->ne--;
+    if(e == last){
+        return;
+    }
+    *e = *last;
+    if(e->next == last){
+        //the last edge is the only edge at its start
+        e->next = e->prev = e;
+    } else {
+        e->next->prev = e;
+        e->prev->next = e;
+    }
+    e->inverse->inverse = e;
+    if(pg->first_edge[e->start] == last){
+        pg->first_edge[e->start] = e;
+    }
+    if(pg->faces_constructed && pg->face_start[e->right_face] == last){
+        pg->face_start[e->right_face] = e;
+    }
+}
+
+/**
+ * Frees the slots of an edge and its inverse, which are no longer used.
+ */
+static void remove_edge_pair_slots(PLANE_GRAPH *pg, PG_EDGE *e){
+    //free the highest slot first, so the last edge is never one of the two
+    PG_EDGE *first = e < e->inverse ? e : e->inverse;
+    PG_EDGE *second = e < e->inverse ? e->inverse : e;
+    remove_edge_slot(pg, second);
+    remove_edge_slot(pg, first);
+}
+
+/**
+ * Frees the number of a face that is no longer used by giving the last face
+ * that number.
+ */
+static void remove_face_number(PLANE_GRAPH *pg, int face){
+    int last = pg->nf - 1;
+    pg->nf--;
+    if(face == last){
+        return;
+    }
+    pg->face_start[face] = pg->face_start[last];
+    pg->face_size[face] = label_face(pg->face_start[last], face);
+}
+
+/**
+ * Frees the number of a vertex without edges by giving the last vertex that number.
+ */
+static void remove_vertex_number(PLANE_GRAPH *pg, int v){
+    int last = pg->nv - 1;
+    pg->nv--;
+    if(v == last){
+        return;
+    }
+    pg->first_edge[v] = pg->first_edge[last];
+    pg->degree[v] = pg->degree[last];
+    PG_EDGE *e, *e_last;
+    e = e_last = pg->first_edge[v];
+    do {
+        e->start = v;
+        e->inverse->end = v;
+        e = e->next;
+    } while (e != e_last);
+}
+
+PG_EDGE *insert_edge(PLANE_GRAPH *pg, PG_EDGE *from_corner, PG_EDGE *to_corner){
+    if(from_corner->start == to_corner->start){
+        return NULL;
+    }
+    if(pg->ne + 2 > pg->maxe){
+        return NULL;
+    }
+    if(pg->faces_constructed &&
+            (from_corner->right_face != to_corner->right_face || pg->nf >= pg->maxf)){
+        return NULL;
+    }
+    int face = from_corner->right_face;
+    int old_size = pg->faces_constructed ? pg->face_size[face] : 0;
+
+    PG_EDGE *e = new_edge(pg, from_corner->start, to_corner->start);
+    PG_EDGE *inverse = new_edge(pg, to_corner->start, from_corner->start);
+    e->inverse = inverse;
+    inverse->inverse = e;
+    insert_in_rotation(pg, e, from_corner);
+    insert_in_rotation(pg, inverse, to_corner);
+
+    if(pg->faces_constructed){
+        //the face of e is new, and the face of its inverse keeps the old number
+        int size = label_face(e, pg->nf);
+        pg->face_start[pg->nf] = e;
+        pg->face_size[pg->nf] = size;
+        pg->nf++;
+        inverse->right_face = face;
+        pg->face_start[face] = inverse;
+        pg->face_size[face] = old_size + 2 - size;
+    }
+
+    return e;
+}
+
+boolean delete_edge(PLANE_GRAPH *pg, PG_EDGE *e){
+    if(pg->degree[e->start] < 2 || pg->degree[e->end] < 2){
+        return FALSE;
+    }
+    int face = e->right_face;
+    int other_face = e->inverse->right_face;
+    if(pg->faces_constructed && face == other_face){
+        return FALSE;
+    }
+
+    //the edge that follows e in its face is not removed
+    PG_EDGE *start = e->inverse->prev;
+    remove_from_rotation(pg, e);
+    remove_from_rotation(pg, e->inverse);
+
+    if(pg->faces_constructed){
+        //the merged face keeps the number of the larger face
+        int kept = pg->face_size[face] >= pg->face_size[other_face] ? face : other_face;
+        int removed = kept == face ? other_face : face;
+        pg->face_start[kept] = start;
+        pg->face_size[kept] = label_face(start, kept);
+        remove_edge_pair_slots(pg, e);
+        remove_face_number(pg, removed);
+    } else {
+        remove_edge_pair_slots(pg, e);
+    }
+
+    return TRUE;
+}
+
+int subdivide_edge(PLANE_GRAPH *pg, PG_EDGE *e){
+    if(pg->nv >= pg->maxn || pg->ne + 2 > pg->maxe){
+        return -1;
+    }
+    int v = pg->nv;
+    pg->nv++;
+    PG_EDGE *inverse = e->inverse;
+
+    //to_start is the new inverse of e, and to_end the new inverse of inverse
+    PG_EDGE *to_start = new_edge(pg, v, e->start);
+    PG_EDGE *to_end = new_edge(pg, v, e->end);
+    e->end = v;
+    inverse->end = v;
+    e->inverse = to_start;
+    to_start->inverse = e;
+    inverse->inverse = to_end;
+    to_end->inverse = inverse;
+
+    to_start->next = to_start->prev = to_end;
+    to_end->next = to_end->prev = to_start;
+    pg->first_edge[v] = to_start;
+    pg->degree[v] = 2;
+
+    if(pg->faces_constructed){
+        to_start->right_face = inverse->right_face;
+        to_end->right_face = e->right_face;
+        pg->face_size[e->right_face]++;
+        pg->face_size[inverse->right_face]++;
+    }
+
+    return v;
+}
+
+boolean contract_edge(PLANE_GRAPH *pg, PG_EDGE *e){
+    int u = e->start;
+    int v = e->end;
+    PG_EDGE *inverse = e->inverse;
+    if(pg->nv <= 2 || pg->degree[u] + pg->degree[v] == 2){
+        return FALSE;
+    }
+    //an edge parallel to e would become a loop
+    PG_EDGE *f = inverse->next;
+    while(f != inverse){
+        if(f->end == u){
+            return FALSE;
+        }
+        f = f->next;
+    }
+    int face = e->right_face;
+    int other_face = inverse->right_face;
+    int degree = pg->degree[u] + pg->degree[v] - 2;
+
+    //the edges that follow e and its inverse in their faces
+    PG_EDGE *after_e = pg->degree[v] > 1 ? inverse->prev : e->prev;
+    PG_EDGE *after_inverse = pg->degree[u] > 1 ? e->prev : inverse->prev;
+
+    //move the edges of v to u: they replace e in the rotation around u
+    if(pg->degree[v] > 1){
+        PG_EDGE *first = inverse->next;
+        PG_EDGE *last = inverse->prev;
+        f = first;
+        while(TRUE){
+            f->start = u;
+            f->inverse->end = u;
+            if(f == last){
+                break;
+            }
+            f = f->next;
+        }
+        if(pg->degree[u] > 1){
+            e->prev->next = first;
+            first->prev = e->prev;
+            e->next->prev = last;
+            last->next = e->next;
+        } else {
+            first->prev = last;
+            last->next = first;
+        }
+        pg->first_edge[u] = first;
+    } else {
+        remove_from_rotation(pg, e);
+    }
+    pg->degree[u] = degree;
+    pg->degree[v] = 0;
+
+    if(pg->faces_constructed){
+        pg->face_start[face] = after_e;
+        pg->face_start[other_face] = after_inverse;
+        pg->face_size[face]--;
+        pg->face_size[other_face]--;
+    }
+
+    remove_edge_pair_slots(pg, e);
+    remove_vertex_number(pg, v);
+
+    return TRUE;
+}
+
+boolean flip_edge(PLANE_GRAPH *pg, PG_EDGE *e){
+    PG_EDGE *inverse = e->inverse;
+    //the triangle on the right of e consists of e, v_x and x_u
+    PG_EDGE *v_x = inverse->prev;
+    PG_EDGE *x_u = v_x->inverse->prev;
+    //the triangle on the left of e consists of inverse, u_y and y_v
+    PG_EDGE *u_y = e->prev;
+    PG_EDGE *y_v = u_y->inverse->prev;
+    if(x_u->inverse->prev != e || y_v->inverse->prev != inverse){
+        return FALSE;
+    }
+    int x = v_x->end;
+    int y = u_y->end;
+    if(x == y || are_adjacent(pg, x, y)){
+        return FALSE;
+    }
+
+    remove_from_rotation(pg, e);
+    remove_from_rotation(pg, inverse);
+
+    //e becomes the edge from x to y, and its inverse the edge from y to x
+    e->start = inverse->end = x;
+    e->end = inverse->start = y;
+    insert_in_rotation(pg, e, x_u);
+    insert_in_rotation(pg, inverse, y_v);
+
+    if(pg->faces_constructed){
+        //the triangle x, y, v keeps the number of the face on the right of e,
+        //and the triangle y, x, u the number of the face on the left of e
+        int face = e->right_face;
+        int other_face = inverse->right_face;
+        y_v->right_face = v_x->right_face = face;
+        x_u->right_face = u_y->right_face = other_face;
+        pg->face_start[face] = e;
+        pg->face_start[other_face] = inverse;
+    }
+
+    return TRUE;
+}
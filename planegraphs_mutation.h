@@ -0,0 +1,85 @@
+/*
+ * Main developer: Nico Van Cleemput
+ *
+ * Copyright (C) 2019 Nico Van Cleemput.
+ * Licensed under the GNU GPL, read the file LICENSE.txt for details.
+ */
+
+/* Local modifications of plane graphs. If the faces of the graph have been
+ * constructed, then the faces are updated by each modification, so there is no
+ * need to call construct_faces again. The vertices, edges and faces stay
+ * numbered consecutively: when an edge, a vertex or a face is removed, the last
+ * one takes its place. As a consequence a pointer to an edge can become invalid
+ * after an edge is deleted or contracted. New edges and vertices are always
+ * added at the end, so pointers stay valid when edges are inserted.
+ */
+
+#ifndef PLANEGRAPH_MUTATION_H
+#define PLANEGRAPH_MUTATION_H
+
+#include "planegraphs_base.h"
+
+/**
+ * Inserts an edge between two corners of the same face. A corner is given by
+ * the edge e leaving a vertex for which the corner is the angle between e and
+ * e->next, i.e., the corner of e->start in the face e->right_face. The new
+ * edge is inserted in that angle at both vertices, and splits the face in two.
+ * The face that contains the inverse of the new edge keeps the number of the
+ * old face. This takes time linear in the size of the new face.
+ * @param pg
+ * @param from_corner the corner at the start of the new edge
+ * @param to_corner the corner at the end of the new edge
+ * @return the new edge from from_corner->start to to_corner->start, or NULL if
+ *         the corners are at the same vertex or in different faces, or if the
+ *         graph has no room for the new edge.
+ */
+PG_EDGE *insert_edge(PLANE_GRAPH *pg, PG_EDGE *from_corner, PG_EDGE *to_corner);
+
+/**
+ * Deletes an edge and its inverse. The two faces of the edge are merged.
+ * This takes time linear in the size of the merged face.
+ * @param pg
+ * @param e
+ * @return FALSE if the edge was not deleted because one of its end points has
+ *         degree 1 or, when the faces are constructed, because it is a bridge.
+ */
+boolean delete_edge(PLANE_GRAPH *pg, PG_EDGE *e);
+
+/**
+ * Subdivides an edge with a new vertex of degree 2. After this e goes from
+ * e->start to the new vertex, and e->inverse from the old end of e to the new
+ * vertex. This takes constant time.
+ * @param pg
+ * @param e
+ * @return the new vertex, or -1 if the graph has no room for the new vertex
+ */
+int subdivide_edge(PLANE_GRAPH *pg, PG_EDGE *e);
+
+/**
+ * Contracts an edge: the end of the edge is merged into its start, and the
+ * edge and its inverse are removed. The last vertex takes the number of the
+ * removed vertex. This takes time linear in the degree of the removed vertex
+ * and of the last vertex. Contracting an edge of a triangle creates parallel
+ * edges.
+ * @param pg
+ * @param e
+ * @return FALSE if the edge was not contracted because it has a parallel edge,
+ *         because both end points have degree 1 or because the graph only has
+ *         2 vertices.
+ */
+boolean contract_edge(PLANE_GRAPH *pg, PG_EDGE *e);
+
+/**
+ * Flips the diagonal e of the quadrangle formed by the two triangles on either
+ * side of it: the edge and its inverse are reused for the other diagonal. The
+ * two triangles keep their numbers. This takes constant time, except for the
+ * check whether the other diagonal is already an edge.
+ * @param pg
+ * @param e
+ * @return FALSE if the edge was not flipped because one of the faces of e is
+ *         not a triangle, or because the end points of the other diagonal are
+ *         equal or already adjacent.
+ */
+boolean flip_edge(PLANE_GRAPH *pg, PG_EDGE *e);
+
+#endif //PLANEGRAPH_MUTATION_H
@@ -6,6 +6,7 @@
  */
 
 #include <stdlib.h>
+#include <string.h>
 #include "planegraphs_output.h"
 
 //----------------PLANAR CODE--------------------
@@ -137,7 +138,10 @@ void write_dual_planar_code(PLANE_GRAPH *pg, FILE *f, boolean print_header){
         fprintf(f, ">>planar_code<<");
     }
 
-    if(!pg->faces_constructed) construct_faces(pg);
+    if(!pg->faces_constructed){
+        fprintf(stderr, "The faces of the graph have not been constructed -- exiting!\n");
+        exit(-1);
+    }
 
     if (pg->nf + 1 <= 255) {
         write_dual_planar_code_char(pg, f);
@@ -149,7 +153,40 @@ void write_dual_planar_code(PLANE_GRAPH *pg, FILE *f, boolean print_header){
     }
 }
 
-void write_planar_code_marked_edges_subdivided_char(PLANE_GRAPH *pg, FILE *f, int marked_edge_count){
+/**
+ * Marks both orientations of each edge of which at least one orientation is
+ * marked in the graph, and stores the number of the subdividing vertex of
+ * these edges. The marks and numbers are stored in the scratch context, so
+ * the graph is not modified.
+ * @param pg
+ * @param scratch
+ * @return the number of marked edges
+ */
+static int label_marked_edges(PLANE_GRAPH *pg, PG_SCRATCH_CONTEXT *scratch){
+    prepare_scratch_context(scratch, pg);
+    int marked_count = 0;
+    for (int i = 0; i < pg->nv - 1; ++i) {
+        PG_EDGE *e, *elast;
+        e = elast = pg->first_edge[i];
+        do {
+            if(e->end > i && (ISMARKED(pg, e) || ISMARKED(pg, e->inverse))){
+                //make sure both orientations are marked
+                SCRATCH_MARK_EDGE(scratch, pg, e);
+                SCRATCH_MARK_EDGE(scratch, pg, e->inverse);
+                //store the subdividing vertex
+                SCRATCH_EDGE_INDEX(scratch, pg, e) = pg->nv + marked_count;
+                SCRATCH_EDGE_INDEX(scratch, pg, e->inverse) = pg->nv + marked_count;
+                //increment counter
+                marked_count++;
+            }
+            e = e->next;
+        } while (e != elast);
+    }
+    return marked_count;
+}
+
+void write_planar_code_marked_edges_subdivided_char(PLANE_GRAPH *pg, FILE *f, int marked_edge_count,
+        PG_SCRATCH_CONTEXT *scratch){
     PG_EDGE *e, *elast;
     int neighbours_extra_edges[marked_edge_count][2];
 
@@ -159,10 +196,11 @@ void write_planar_code_marked_edges_subdivided_char(PLANE_GRAPH *pg, FILE *f, in
     for(int i=0; i<pg->nv; i++){
         e = elast = pg->first_edge[i];
         do {
-            if(ISMARKED(pg, e)){
-                fputc(e->index + 1, f);
-                neighbours_extra_edges[e->index - pg->nv][0] = e->start;
-                neighbours_extra_edges[e->index - pg->nv][1] = e->end;
+            if(SCRATCH_ISMARKED_EDGE(scratch, pg, e)){
+                int subdivision = SCRATCH_EDGE_INDEX(scratch, pg, e);
+                fputc(subdivision + 1, f);
+                neighbours_extra_edges[subdivision - pg->nv][0] = e->start;
+                neighbours_extra_edges[subdivision - pg->nv][1] = e->end;
             } else {
                 fputc(e->end + 1, f);
             }
@@ -177,7 +215,8 @@ void write_planar_code_marked_edges_subdivided_char(PLANE_GRAPH *pg, FILE *f, in
     }
 }
 
-void write_planar_code_marked_edges_subdivided_short(PLANE_GRAPH *pg, FILE *f, int marked_edge_count){
+void write_planar_code_marked_edges_subdivided_short(PLANE_GRAPH *pg, FILE *f, int marked_edge_count,
+        PG_SCRATCH_CONTEXT *scratch){
     int i;
     PG_EDGE *e, *elast;
     int neighbours_extra_edges[marked_edge_count][2];
@@ -194,14 +233,15 @@ void write_planar_code_marked_edges_subdivided_short(PLANE_GRAPH *pg, FILE *f, i
     for(i=0; i<pg->nv; i++){
         e = elast = pg->first_edge[i];
         do {
-            if(ISMARKED(pg, e)){
-                temp = e->index + 1;
+            if(SCRATCH_ISMARKED_EDGE(scratch, pg, e)){
+                int subdivision = SCRATCH_EDGE_INDEX(scratch, pg, e);
+                temp = subdivision + 1;
                 if (fwrite(&temp, sizeof (unsigned short), 1, f) != 1) {
                     fprintf(stderr, "fwrite() failed -- exiting!\n");
                     exit(EXIT_FAILURE);
                 }
-                neighbours_extra_edges[e->index - pg->nv][0] = e->start;
-                neighbours_extra_edges[e->index - pg->nv][1] = e->end;
+                neighbours_extra_edges[subdivision - pg->nv][0] = e->start;
+                neighbours_extra_edges[subdivision - pg->nv][1] = e->end;
             } else {
                 temp = e->end + 1;
                 if (fwrite(&temp, sizeof (unsigned short), 1, f) != 1) {
@@ -247,30 +287,13 @@ void write_planar_code_marked_edges_subdivided(PLANE_GRAPH *pg, FILE *f, boolean
         fprintf(f, ">>planar_code<<");
     }
 
-    //determine the number of marked edges
-    int marked_count = 0;
-    for (int i = 0; i < pg->nv - 1; ++i) {
-        PG_EDGE *e, *elast;
-        e = elast = pg->first_edge[i];
-        do {
-            if(e->end > i && (ISMARKED(pg, e) || ISMARKED(pg, e->inverse))){
-                //make sure both orientations are marked
-                MARK(pg, e);
-                MARK(pg, e->inverse);
-                //store the subdividing vertex in index
-                e->index = pg->nv + marked_count;
-                e->inverse->index = pg->nv + marked_count;
-                //increment counter
-                marked_count++;
-            }
-            e = e->next;
-        } while (e != elast);
-    }
+    PG_SCRATCH_CONTEXT *scratch = get_thread_scratch_context();
+    int marked_count = label_marked_edges(pg, scratch);
 
     if (pg->nv + marked_count + 1 <= 255) {
-        write_planar_code_marked_edges_subdivided_char(pg, f, marked_count);
+        write_planar_code_marked_edges_subdivided_char(pg, f, marked_count, scratch);
     } else if (pg->nv + marked_count + 1 <= 65535) {
-        write_planar_code_marked_edges_subdivided_short(pg, f, marked_count);
+        write_planar_code_marked_edges_subdivided_short(pg, f, marked_count, scratch);
     } else {
         fprintf(stderr, "Graphs of that size are currently not supported -- exiting!\n");
         exit(EXIT_FAILURE);
@@ -280,7 +303,33 @@ void write_planar_code_marked_edges_subdivided(PLANE_GRAPH *pg, FILE *f, boolean
 
 //----------------EDGE CODE--------------------
 
-void write_edge_code_small(PLANE_GRAPH *pg, FILE *f){
+/**
+ * Numbers the edges of the graph: both orientations of an edge get the same
+ * number, which is stored in the scratch context.
+ * @param pg
+ * @param scratch
+ */
+static void label_edges(PLANE_GRAPH *pg, PG_SCRATCH_CONTEXT *scratch){
+    int i, counter=0;
+    PG_EDGE *e, *elast;
+    
+    prepare_scratch_context(scratch, pg);
+    for(i=0; i<pg->nv; i++){
+        e = elast = pg->first_edge[i];
+        do {
+            if(!SCRATCH_ISMARKED_EDGE(scratch, pg, e)){
+                SCRATCH_MARK_EDGE(scratch, pg, e);
+                SCRATCH_MARK_EDGE(scratch, pg, e->inverse);
+                SCRATCH_EDGE_INDEX(scratch, pg, e) = counter;
+                SCRATCH_EDGE_INDEX(scratch, pg, e->inverse) = counter;
+                counter++;
+            }
+            e = e->next;
+        } while (e != elast);
+    }
+}
+
+void write_edge_code_small(PLANE_GRAPH *pg, FILE *f, PG_SCRATCH_CONTEXT *scratch){
     int i;
     PG_EDGE *e, *elast;
     
@@ -290,7 +339,7 @@ void write_edge_code_small(PLANE_GRAPH *pg, FILE *f){
     for(i=0; i<pg->nv; i++){
         e = elast = pg->first_edge[i];
         do {
-            fputc(e->index, f);
+            fputc(SCRATCH_EDGE_INDEX(scratch, pg, e), f);
             e = e->next;
         } while (e != elast);
         if(i < pg->nv - 1){
@@ -314,7 +363,7 @@ void write_big_endian_multibyte(FILE *f, int number, int bytecount){
     }    
 }
 
-void write_edge_code_large(PLANE_GRAPH *pg, FILE *f){
+void write_edge_code_large(PLANE_GRAPH *pg, FILE *f, PG_SCRATCH_CONTEXT *scratch){
     int i;
     PG_EDGE *e, *elast;
     
@@ -368,7 +417,7 @@ void write_edge_code_large(PLANE_GRAPH *pg, FILE *f){
     for(i=0; i<pg->nv; i++){
         e = elast = pg->first_edge[i];
         do {
-            write_big_endian_multibyte(f, e->index, l);
+            write_big_endian_multibyte(f, SCRATCH_EDGE_INDEX(scratch, pg, e), l);
             e = e->next;
         } while (e != elast);
         if(i <pg-> nv - 1){
@@ -378,42 +427,22 @@ void write_edge_code_large(PLANE_GRAPH *pg, FILE *f){
 }
 
 void write_edge_code(PLANE_GRAPH *pg, FILE *f, boolean print_header){
-    int i, counter=0;
-    PG_EDGE *e, *elast;
-    
     if(print_header){
         fprintf(f, ">>edge_code<<");
     }
     
-    //label the edges
-    for(i=0; i<pg->nv; i++){
-        e = elast = pg->first_edge[i];
-        do {
-            e->index = -1;
-            e = e->next;
-        } while (e != elast);
-    }
-    for(i=0; i<pg->nv; i++){
-        e = elast = pg->first_edge[i];
-        do {
-            if(e->index == -1){
-                e->index = counter;
-                e->inverse->index = counter;
-                counter++;
-            }
-            e = e->next;
-        } while (e != elast);
-    }
+    PG_SCRATCH_CONTEXT *scratch = get_thread_scratch_context();
+    label_edges(pg, scratch);
     
     if (pg->ne + pg->nv - 1 <= 255) {
-        write_edge_code_small(pg, f);
+        write_edge_code_small(pg, f, scratch);
     } else {
-        write_edge_code_large(pg, f);
+        write_edge_code_large(pg, f, scratch);
     }
     
 }
 
-void write_dual_edge_code_small(PLANE_GRAPH *pg, FILE *f){
+void write_dual_edge_code_small(PLANE_GRAPH *pg, FILE *f, PG_SCRATCH_CONTEXT *scratch){
     PG_EDGE *e, *elast;
 
     //write the length of the body
@@ -422,7 +451,7 @@ void write_dual_edge_code_small(PLANE_GRAPH *pg, FILE *f){
     for(int i=0; i<pg->nf; i++){
         e = elast = pg->face_start[i];
         do {
-            fputc(e->index, f);
+            fputc(SCRATCH_EDGE_INDEX(scratch, pg, e), f);
             e = e->inverse->prev;
         } while (e != elast);
         if(i < pg->nf - 1){
@@ -443,39 +472,699 @@ void write_dual_edge_code_large(PLANE_GRAPH *pg, FILE *f){
  * @param print_header Include the header for this code
  */
 void write_dual_edge_code(PLANE_GRAPH *pg, FILE *f, boolean print_header){
-    int counter=0;
-    PG_EDGE *e, *elast;
-
     if(print_header){
         fprintf(f, ">>edge_code<<");
     }
 
-    if(!pg->faces_constructed) construct_faces(pg);
+    if(!pg->faces_constructed){
+        fprintf(stderr, "The faces of the graph have not been constructed -- exiting!\n");
+        exit(-1);
+    }
+
+    PG_SCRATCH_CONTEXT *scratch = get_thread_scratch_context();
+    label_edges(pg, scratch);
+
+    if (pg->ne + pg->nf - 1 <= 255) {
+        write_dual_edge_code_small(pg, f, scratch);
+    } else {
+        write_dual_edge_code_large(pg, f);
+    }
+
+}
+
+//----------------ENCODING--------------------
+
+static inline unsigned char *store_short(unsigned char *position, unsigned short value){
+    memcpy(position, &value, sizeof(unsigned short));
+    return position + sizeof(unsigned short);
+}
+
+size_t planar_code_size(PLANE_GRAPH *pg){
+    if (pg->nv + 1 <= 255) {
+        return 1 + pg->nv + pg->ne;
+    } else if (pg->nv + 1 <= 65535) {
+        return 1 + (1 + pg->nv + pg->ne)*sizeof(unsigned short);
+    } else {
+        return 0;
+    }
+}
+
+/**
+ * Stores the planar code of the graph at the given position without any
+ * checks: the caller should make sure that planar_code_size(pg) bytes are
+ * available.
+ * @return the number of bytes that were stored
+ */
+static size_t store_planar_code(PLANE_GRAPH *pg, unsigned char *buffer){
+    PG_EDGE *e, *elast;
+    unsigned char *position = buffer;
+    
+    if (pg->nv + 1 <= 255) {
+        *position++ = pg->nv;
+        for(int i=0; i<pg->nv; i++){
+            e = elast = pg->first_edge[i];
+            do {
+                *position++ = e->end + 1;
+                e = e->next;
+            } while (e != elast);
+            *position++ = 0;
+        }
+    } else {
+        *position++ = 0;
+        position = store_short(position, pg->nv);
+        for(int i=0; i<pg->nv; i++){
+            e = elast = pg->first_edge[i];
+            do {
+                position = store_short(position, e->end + 1);
+                e = e->next;
+            } while (e != elast);
+            position = store_short(position, 0);
+        }
+    }
+    
+    return position - buffer;
+}
+
+size_t encode_planar_code(PLANE_GRAPH *pg, unsigned char *buffer, size_t capacity){
+    size_t size = planar_code_size(pg);
+    
+    if(size == 0 || size > capacity){
+        return 0;
+    }
+    
+    return store_planar_code(pg, buffer);
+}
+
+//----------------WRITER--------------------
+
+PG_WRITER *new_plane_graph_writer(FILE *file, boolean print_header){
+    PG_WRITER *writer = (PG_WRITER *)malloc(sizeof(PG_WRITER));
+    
+    if(writer == NULL){
+        fprintf(stderr, "Insufficient memory for writer.\n");
+        return NULL;
+    }
+    
+    writer->buffer = (unsigned char *)malloc(PG_WRITER_BUFFER_SIZE);
+    
+    if(writer->buffer == NULL){
+        fprintf(stderr, "Insufficient memory for writer buffer.\n");
+        free(writer);
+        return NULL;
+    }
+    
+    writer->file = file;
+    writer->print_header = print_header;
+    writer->first = TRUE;
+    writer->buffer_size = PG_WRITER_BUFFER_SIZE;
+    writer->length = 0;
+    writer->error = FALSE;
+    writer->scratch = NULL;
+    
+    return writer;
+}
+
+boolean flush_plane_graph_writer(PG_WRITER *writer){
+    if(writer->length){
+        if(fwrite(writer->buffer, sizeof(unsigned char), writer->length, writer->file) != writer->length){
+            fprintf(stderr, "fwrite() failed.\n");
+            writer->error = TRUE;
+        }
+        writer->length = 0;
+    }
+    return !writer->error;
+}
+
+boolean free_plane_graph_writer(PG_WRITER *writer){
+    boolean success = flush_plane_graph_writer(writer);
+    free(writer->buffer);
+    free(writer);
+    return success;
+}
+
+/**
+ * Makes sure that the header (if needed) and the given number of bytes fit 
+ * in the buffer of the writer. The buffer is flushed when it is too full, 
+ * and only grows when the code of a single graph does not fit in it.
+ * @param writer
+ * @param needed
+ * @param header
+ * @return a pointer to the position in the buffer where the code should be
+ *         stored, or NULL if insufficient memory was available or the
+ *         output could not be written
+ */
+static unsigned char *reserve_in_writer(PG_WRITER *writer, size_t needed, const char *header){
+    if(writer->error){
+        return NULL;
+    }
+    
+    if(writer->first){
+        writer->first = FALSE;
+        if(writer->print_header){
+            if(fputs(header, writer->file) == EOF){
+                fprintf(stderr, "fputs() failed.\n");
+                writer->error = TRUE;
+                return NULL;
+            }
+        }
+    }
+    
+    if(writer->length + needed > writer->buffer_size){
+        if(!flush_plane_graph_writer(writer)){
+            return NULL;
+        }
+        if(needed > writer->buffer_size){
+            unsigned char *new_buffer = (unsigned char *)realloc(writer->buffer, needed);
+            if(new_buffer == NULL){
+                fprintf(stderr, "Insufficient memory for writer buffer.\n");
+                return NULL;
+            }
+            writer->buffer = new_buffer;
+            writer->buffer_size = needed;
+        }
+    }
+    
+    return writer->buffer + writer->length;
+}
+
+/**
+ * Returns the scratch context used by the writer.
+ */
+static PG_SCRATCH_CONTEXT *get_writer_scratch_context(PG_WRITER *writer){
+    return writer->scratch == NULL ? get_thread_scratch_context() : writer->scratch;
+}
+
+boolean write_planar_code_to_writer(PG_WRITER *writer, PLANE_GRAPH *pg){
+    size_t size = planar_code_size(pg);
+    
+    if(size == 0){
+        fprintf(stderr, "Graphs of that size are currently not supported.\n");
+        return FALSE;
+    }
+    
+    unsigned char *position = reserve_in_writer(writer, size, ">>planar_code<<");
+    if(position == NULL) return FALSE;
+    
+    writer->length += store_planar_code(pg, position);
+    return TRUE;
+}
+
+boolean write_dual_planar_code_to_writer(PG_WRITER *writer, PLANE_GRAPH *pg){
+    PG_EDGE *e, *elast;
+    unsigned char *start, *position;
+    
+    if(!pg->faces_constructed){
+        fprintf(stderr, "The faces of the graph have not been constructed.\n");
+        return FALSE;
+    }
+    
+    if (pg->nf + 1 <= 255) {
+        start = position = reserve_in_writer(writer, 1 + pg->nf + pg->ne, ">>planar_code<<");
+        if(start == NULL) return FALSE;
+        
+        *position++ = pg->nf;
+        for(int i=0; i<pg->nf; i++){
+            e = elast = pg->face_start[i];
+            do {
+                *position++ = e->inverse->right_face + 1;
+                e = e->inverse->prev;
+            } while (e != elast);
+            *position++ = 0;
+        }
+    } else if (pg->nf + 1 <= 65535) {
+        start = position = reserve_in_writer(writer, 1 + (1 + pg->nf + pg->ne)*sizeof(unsigned short), ">>planar_code<<");
+        if(start == NULL) return FALSE;
+        
+        *position++ = 0;
+        position = store_short(position, pg->nf);
+        for(int i=0; i<pg->nf; i++){
+            e = elast = pg->face_start[i];
+            do {
+                position = store_short(position, e->inverse->right_face + 1);
+                e = e->inverse->prev;
+            } while (e != elast);
+            position = store_short(position, 0);
+        }
+    } else {
+        fprintf(stderr, "Graphs of that size are currently not supported.\n");
+        return FALSE;
+    }
+    
+    writer->length += position - start;
+    return TRUE;
+}
+
+boolean write_planar_code_marked_edges_subdivided_to_writer(PG_WRITER *writer, PLANE_GRAPH *pg){
+    PG_EDGE *e, *elast;
+    unsigned char *start, *position, *extra;
+    
+    PG_SCRATCH_CONTEXT *scratch = get_writer_scratch_context(writer);
+    int marked_count = label_marked_edges(pg, scratch);
+    int nv = pg->nv + marked_count;
+    //each new vertex has two neighbours
+    size_t entries = 1 + pg->nv + pg->ne + 3*marked_count;
+    
+    if (nv + 1 <= 255) {
+        start = position = reserve_in_writer(writer, entries, ">>planar_code<<");
+        if(start == NULL) return FALSE;
+        
+        //the neighbours of the new vertices are stored after those of the original vertices
+        extra = start + 1 + pg->nv + pg->ne;
+        *position++ = nv;
+        for(int i=0; i<pg->nv; i++){
+            e = elast = pg->first_edge[i];
+            do {
+                if(SCRATCH_ISMARKED_EDGE(scratch, pg, e)){
+                    int subdivision = SCRATCH_EDGE_INDEX(scratch, pg, e);
+                    *position++ = subdivision + 1;
+                    extra[3*(subdivision - pg->nv)] = e->start + 1;
+                    extra[3*(subdivision - pg->nv) + 1] = e->end + 1;
+                    extra[3*(subdivision - pg->nv) + 2] = 0;
+                } else {
+                    *position++ = e->end + 1;
+                }
+                e = e->next;
+            } while (e != elast);
+            *position++ = 0;
+        }
+        position += 3*marked_count;
+    } else if (nv + 1 <= 65535) {
+        start = position = reserve_in_writer(writer, 1 + entries*sizeof(unsigned short), ">>planar_code<<");
+        if(start == NULL) return FALSE;
+        
+        extra = start + 1 + (1 + pg->nv + pg->ne)*sizeof(unsigned short);
+        *position++ = 0;
+        position = store_short(position, nv);
+        for(int i=0; i<pg->nv; i++){
+            e = elast = pg->first_edge[i];
+            do {
+                if(SCRATCH_ISMARKED_EDGE(scratch, pg, e)){
+                    int subdivision = SCRATCH_EDGE_INDEX(scratch, pg, e);
+                    position = store_short(position, subdivision + 1);
+                    unsigned char *neighbours = extra + 3*(subdivision - pg->nv)*sizeof(unsigned short);
+                    neighbours = store_short(neighbours, e->start + 1);
+                    neighbours = store_short(neighbours, e->end + 1);
+                    store_short(neighbours, 0);
+                } else {
+                    position = store_short(position, e->end + 1);
+                }
+                e = e->next;
+            } while (e != elast);
+            position = store_short(position, 0);
+        }
+        position += 3*marked_count*sizeof(unsigned short);
+    } else {
+        fprintf(stderr, "Graphs of that size are currently not supported.\n");
+        return FALSE;
+    }
+    
+    writer->length += position - start;
+    return TRUE;
+}
 
-    //label the edges
+boolean write_edge_code_to_writer(PG_WRITER *writer, PLANE_GRAPH *pg){
+    PG_EDGE *e, *elast;
+    unsigned char *start, *position;
+    
+    if (pg->ne + pg->nv - 1 > 255) {
+        fprintf(stderr, "Graphs of that size are currently not supported.\n");
+        return FALSE;
+    }
+    
+    PG_SCRATCH_CONTEXT *scratch = get_writer_scratch_context(writer);
+    label_edges(pg, scratch);
+    
+    start = position = reserve_in_writer(writer, pg->ne + pg->nv, ">>edge_code<<");
+    if(start == NULL) return FALSE;
+    
+    //the length of the body
+    *position++ = pg->ne + pg->nv - 1;
     for(int i=0; i<pg->nv; i++){
         e = elast = pg->first_edge[i];
         do {
-            e->index = -1;
+            *position++ = SCRATCH_EDGE_INDEX(scratch, pg, e);
             e = e->next;
         } while (e != elast);
+        if(i < pg->nv - 1){
+            *position++ = 255;
+        }
+    }
+    
+    writer->length += position - start;
+    return TRUE;
+}
+
+boolean write_dual_edge_code_to_writer(PG_WRITER *writer, PLANE_GRAPH *pg){
+    PG_EDGE *e, *elast;
+    unsigned char *start, *position;
+    
+    if(!pg->faces_constructed){
+        fprintf(stderr, "The faces of the graph have not been constructed.\n");
+        return FALSE;
+    }
+    
+    if (pg->ne + pg->nf - 1 > 255) {
+        fprintf(stderr, "Graphs of that size are currently not supported.\n");
+        return FALSE;
+    }
+    
+    PG_SCRATCH_CONTEXT *scratch = get_writer_scratch_context(writer);
+    label_edges(pg, scratch);
+    
+    start = position = reserve_in_writer(writer, pg->ne + pg->nf, ">>edge_code<<");
+    if(start == NULL) return FALSE;
+    
+    //the length of the body
+    *position++ = pg->ne + pg->nf - 1;
+    for(int i=0; i<pg->nf; i++){
+        e = elast = pg->face_start[i];
+        do {
+            *position++ = SCRATCH_EDGE_INDEX(scratch, pg, e);
+            e = e->inverse->prev;
+        } while (e != elast);
+        if(i < pg->nf - 1){
+            *position++ = 255;
+        }
+    }
+    
+    writer->length += position - start;
+    return TRUE;
+}
+
+//----------------COMPRESSED PLANAR CODE--------------------
+
+static inline unsigned char *store_varint(unsigned char *position, uint64_t value){
+    while(value >= 0x80){
+        *position++ = (unsigned char)(value | 0x80);
+        value >>= 7;
+    }
+    *position++ = (unsigned char)value;
+    return position;
+}
+
+//maps small negative and positive differences to small unsigned numbers
+static inline uint64_t zigzag(int value){
+    return value < 0 ? 2*(uint64_t)(-(int64_t)value) - 1 : 2*(uint64_t)value;
+}
+
+static boolean store_uint64(FILE *file, uint64_t value){
+    unsigned char bytes[8];
+    for(int i = 0; i < 8; i++){
+        bytes[i] = (unsigned char)(value >> (8*i));
+    }
+    return fwrite(bytes, 1, 8, file) == 8;
+}
+
+PG_COMPRESSED_WRITER *new_compressed_planar_code_writer(FILE *file){
+    PG_COMPRESSED_WRITER *writer = (PG_COMPRESSED_WRITER *)malloc(sizeof(PG_COMPRESSED_WRITER));
+    
+    if(writer == NULL){
+        fprintf(stderr, "Insufficient memory for writer.\n");
+        return NULL;
+    }
+    
+    writer->block_allocated = 2*PG_COMPRESSED_BLOCK_SIZE;
+    writer->block = (unsigned char *)malloc(writer->block_allocated);
+    writer->blocks_allocated = 64;
+    writer->block_offsets = (uint64_t *)malloc(sizeof(uint64_t) * writer->blocks_allocated);
+    writer->block_first_graphs = (uint64_t *)malloc(sizeof(uint64_t) * writer->blocks_allocated);
+    
+    if(writer->block == NULL || writer->block_offsets == NULL || writer->block_first_graphs == NULL){
+        fprintf(stderr, "Insufficient memory for writer buffer.\n");
+        free(writer->block);
+        free(writer->block_offsets);
+        free(writer->block_first_graphs);
+        free(writer);
+        return NULL;
+    }
+    
+    writer->file = file;
+    writer->block_length = 0;
+    writer->block_graph_count = 0;
+    writer->block_count = 0;
+    writer->graph_count = 0;
+    writer->error = FALSE;
+    
+    if(fputs(PG_COMPRESSED_HEADER, file) == EOF){
+        fprintf(stderr, "fputs() failed.\n");
+        writer->error = TRUE;
+    }
+    writer->position = strlen(PG_COMPRESSED_HEADER);
+    
+    return writer;
+}
+
+/**
+ * Writes the current block to the file and adds it to the index.
+ */
+static boolean write_compressed_block(PG_COMPRESSED_WRITER *writer){
+    unsigned char block_header[20];
+    
+    if(writer->error){
+        return FALSE;
+    }
+    if(writer->block_graph_count == 0){
+        return TRUE;
+    }
+    
+    if(writer->block_count == writer->blocks_allocated){
+        size_t new_size = 2 * writer->blocks_allocated;
+        uint64_t *new_offsets = (uint64_t *)realloc(writer->block_offsets, sizeof(uint64_t) * new_size);
+        if(new_offsets == NULL){
+            fprintf(stderr, "Insufficient memory for block index.\n");
+            writer->error = TRUE;
+            return FALSE;
+        }
+        writer->block_offsets = new_offsets;
+        uint64_t *new_first_graphs = (uint64_t *)realloc(writer->block_first_graphs, sizeof(uint64_t) * new_size);
+        if(new_first_graphs == NULL){
+            fprintf(stderr, "Insufficient memory for block index.\n");
+            writer->error = TRUE;
+            return FALSE;
+        }
+        writer->block_first_graphs = new_first_graphs;
+        writer->blocks_allocated = new_size;
+    }
+    
+    writer->block_offsets[writer->block_count] = writer->position;
+    writer->block_first_graphs[writer->block_count] = writer->graph_count - writer->block_graph_count;
+    writer->block_count++;
+    
+    unsigned char *end = store_varint(block_header, writer->block_graph_count);
+    end = store_varint(end, writer->block_length);
+    size_t header_length = end - block_header;
+    
+    if(fwrite(block_header, 1, header_length, writer->file) != header_length ||
+            fwrite(writer->block, 1, writer->block_length, writer->file) != writer->block_length){
+        fprintf(stderr, "fwrite() failed.\n");
+        writer->error = TRUE;
+        return FALSE;
+    }
+    
+    writer->position += header_length + writer->block_length;
+    writer->block_length = 0;
+    writer->block_graph_count = 0;
+    
+    return TRUE;
+}
+
+/**
+ * Makes sure that needed bytes are available at the end of the current 
+ * block. A block is only written to the file between two graphs.
+ */
+static unsigned char *reserve_in_block(PG_COMPRESSED_WRITER *writer, size_t needed){
+    if(writer->error){
+        return NULL;
+    }
+    if(writer->block_length >= PG_COMPRESSED_BLOCK_SIZE && !write_compressed_block(writer)){
+        return NULL;
     }
+    if(writer->block_length + needed > writer->block_allocated){
+        size_t new_size = writer->block_length + needed;
+        unsigned char *new_block = (unsigned char *)realloc(writer->block, new_size);
+        if(new_block == NULL){
+            fprintf(stderr, "Insufficient memory for writer buffer.\n");
+            writer->error = TRUE;
+            return NULL;
+        }
+        writer->block = new_block;
+        writer->block_allocated = new_size;
+    }
+    return writer->block + writer->block_length;
+}
+
+boolean write_compressed_planar_code(PG_COMPRESSED_WRITER *writer, PLANE_GRAPH *pg){
+    PG_EDGE *e, *elast;
+    
+    if(pg->nv + 1 > 65535){
+        fprintf(stderr, "Graphs of that size are currently not supported.\n");
+        return FALSE;
+    }
+    
+    //no entry needs more than 3 bytes
+    unsigned char *start = reserve_in_block(writer, 3*(1 + pg->nv + pg->ne));
+    if(start == NULL) return FALSE;
+    
+    unsigned char *position = store_varint(start, pg->nv);
     for(int i=0; i<pg->nv; i++){
+        position = store_varint(position, pg->degree[i]);
+        int previous = i;
         e = elast = pg->first_edge[i];
         do {
-            if(e->index == -1){
-                e->index = counter;
-                e->inverse->index = counter;
-                counter++;
-            }
+            position = store_varint(position, zigzag(e->end - previous));
+            previous = e->end;
             e = e->next;
         } while (e != elast);
     }
+    
+    writer->block_length += position - start;
+    writer->block_graph_count++;
+    writer->graph_count++;
+    return TRUE;
+}
 
-    if (pg->ne + pg->nf - 1 <= 255) {
-        write_dual_edge_code_small(pg, f);
+boolean write_compressed_planar_code_from_code(PG_COMPRESSED_WRITER *writer, unsigned short *code, int length){
+    int nv = code[0];
+    
+    //no entry needs more than 3 bytes
+    unsigned char *start = reserve_in_block(writer, 3*length);
+    if(start == NULL) return FALSE;
+    
+    unsigned char *position = store_varint(start, nv);
+    int current = 1;
+    for(int i=0; i<nv; i++){
+        int degree = 0;
+        while(current + degree < length && code[current + degree] != 0){
+            degree++;
+        }
+        if(degree == 0 || current + degree == length){
+            fprintf(stderr, "Invalid planar code.\n");
+            return FALSE;
+        }
+        position = store_varint(position, degree);
+        int previous = i;
+        for(int j = 0; j < degree; j++){
+            int neighbour = code[current + j] - 1;
+            if(neighbour < 0 || neighbour >= nv){
+                fprintf(stderr, "Invalid planar code.\n");
+                return FALSE;
+            }
+            position = store_varint(position, zigzag(neighbour - previous));
+            previous = neighbour;
+        }
+        current += degree + 1;
+    }
+    
+    writer->block_length += position - start;
+    writer->block_graph_count++;
+    writer->graph_count++;
+    return TRUE;
+}
+
+boolean close_compressed_planar_code_writer(PG_COMPRESSED_WRITER *writer){
+    boolean success = write_compressed_block(writer);
+    
+    if(success){
+        //the end of the blocks is marked by a block without graphs
+        uint64_t index_offset = writer->position + 1;
+        success = fputc(0, writer->file) != EOF;
+        
+        for(size_t i = 0; success && i < writer->block_count; i++){
+            success = store_uint64(writer->file, writer->block_offsets[i]) &&
+                      store_uint64(writer->file, writer->block_first_graphs[i]);
+        }
+        
+        success = success && 
+                  store_uint64(writer->file, index_offset) &&
+                  store_uint64(writer->file, writer->block_count) &&
+                  store_uint64(writer->file, writer->graph_count) &&
+                  fwrite(PG_COMPRESSED_TRAILER, 1, 8, writer->file) == 8;
+        
+        if(!success){
+            fprintf(stderr, "fwrite() failed.\n");
+        }
+    }
+    
+    free(writer->block);
+    free(writer->block_offsets);
+    free(writer->block_first_graphs);
+    free(writer);
+    
+    return success;
+}
+
+/**
+ * Writes the code that is stored as an array of unsigned shorts as planar
+ * code.
+ */
+static boolean write_code_to_writer(PG_WRITER *writer, unsigned short *code, int length){
+    unsigned char *position;
+    
+    if(code[0] + 1 <= 255){
+        position = reserve_in_writer(writer, length, ">>planar_code<<");
+        if(position == NULL) return FALSE;
+        for(int i = 0; i < length; i++){
+            position[i] = (unsigned char) code[i];
+        }
+        writer->length += length;
     } else {
-        write_dual_edge_code_large(pg, f);
+        position = reserve_in_writer(writer, 1 + length*sizeof(unsigned short), ">>planar_code<<");
+        if(position == NULL) return FALSE;
+        *position = 0;
+        memcpy(position + 1, code, length*sizeof(unsigned short));
+        writer->length += 1 + length*sizeof(unsigned short);
     }
+    
+    return TRUE;
+}
+
+boolean compress_planar_code(FILE *in, FILE *out, PG_INPUT_OPTIONS *options){
+    int length;
+    boolean success = TRUE;
+    
+    PG_READER *reader = new_planar_code_reader(in, options);
+    if(reader == NULL){
+        return FALSE;
+    }
+    PG_COMPRESSED_WRITER *writer = new_compressed_planar_code_writer(out);
+    if(writer == NULL){
+        free_planar_code_reader(reader);
+        return FALSE;
+    }
+    
+    while(success && (length = read_planar_code_into_reader_buffer(reader))){
+        success = write_compressed_planar_code_from_code(writer, reader->code, length);
+    }
+    
+    //the graphs that were read before an error are still stored with an index,
+    //but the conversion is not successful
+    success = close_compressed_planar_code_writer(writer) && success && !reader->error;
+    free_planar_code_reader(reader);
+    
+    return success;
+}
 
+boolean decompress_planar_code(FILE *in, FILE *out, boolean print_header){
+    int length;
+    boolean success = TRUE;
+    DEFAULT_PG_INPUT_OPTIONS(options);
+    
+    PG_COMPRESSED_READER *reader = new_compressed_planar_code_reader(in, &options);
+    if(reader == NULL){
+        return FALSE;
+    }
+    PG_WRITER *writer = new_plane_graph_writer(out, print_header);
+    if(writer == NULL){
+        free_compressed_planar_code_reader(reader);
+        return FALSE;
+    }
+    
+    while(success && (length = read_compressed_planar_code_into_reader_buffer(reader))){
+        success = write_code_to_writer(writer, reader->code, length);
+    }
+    
+    success = free_plane_graph_writer(writer) && success && !reader->error;
+    free_compressed_planar_code_reader(reader);
+    
+    return success;
 }
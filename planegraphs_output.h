@@ -9,7 +9,10 @@
 #define	PLANEGRAPH_OUTPUT_H
 
 #include "planegraphs_base.h"
+#include "planegraphs_input.h"
+#include "planegraphs_scratch.h"
 #include <stdio.h>
+#include <stdint.h>
 
 #ifdef	__cplusplus
 extern "C" {
@@ -24,7 +27,8 @@ extern "C" {
 void write_planar_code(PLANE_GRAPH *pg, FILE *f, boolean print_header);
 
 /**
- * Output the planar code of the dual of the graph
+ * Output the planar code of the dual of the graph. The faces of the graph
+ * should be constructed; this function exits otherwise.
  * @param pg
  * @param f
  * @param print_header Include the header for this code
@@ -33,6 +37,8 @@ void write_dual_planar_code(PLANE_GRAPH *pg, FILE *f, boolean print_header);
 
 /**
  * Output the planar code of the graph and subdivides each marked edge with a single vertex.
+ * An edge is subdivided if at least one of its orientations is marked. The
+ * marks of the graph are only read, so they are unchanged afterwards.
  * @param pg
  * @param f
  * @param print_header Include the header for this code
@@ -48,13 +54,223 @@ void write_planar_code_marked_edges_subdivided(PLANE_GRAPH *pg, FILE *f, boolean
 void write_edge_code(PLANE_GRAPH *pg, FILE *f, boolean print_header);
 
 /**
- * Output the edge code of the dual of the graph
+ * Output the edge code of the dual of the graph. The faces of the graph
+ * should be constructed; this function exits otherwise.
  * @param pg
  * @param f
  * @param print_header Include the header for this code
  */
 void write_dual_edge_code(PLANE_GRAPH *pg, FILE *f, boolean print_header);
 
+/**
+ * Determines the number of bytes needed to store the planar code of the graph
+ * (without header).
+ * @param pg
+ * @return the size of the planar code, or 0 if the graph is too large to be
+ *         stored in planar code
+ */
+size_t planar_code_size(PLANE_GRAPH *pg);
+
+/**
+ * Stores the planar code of the graph (without header) in the given buffer.
+ * The code uses one byte per entry if possible, and an unsigned short per
+ * entry otherwise, exactly as write_planar_code.
+ * @param pg
+ * @param buffer
+ * @param capacity the number of bytes available in the buffer
+ * @return the number of bytes written, or 0 if the buffer is too small or
+ *         the graph is too large to be stored in planar code
+ */
+size_t encode_planar_code(PLANE_GRAPH *pg, unsigned char *buffer, size_t capacity);
+
+typedef struct __plane_graph_writer PG_WRITER;
+
+/* A writer encodes complete graphs into a large buffer, and only writes
+ * this buffer to the file when it is full or when the writer is flushed.
+ * The header is written at most once: before the first graph that is
+ * written by the writer.
+ */
+struct __plane_graph_writer {
+    FILE *file;
+    
+    boolean print_header;
+    //TRUE as long as nothing has been written by this writer
+    boolean first;
+    
+    unsigned char *buffer;
+    size_t buffer_size;
+    //the number of bytes in the buffer that still need to be written
+    size_t length;
+    
+    //TRUE if a write to the file failed
+    boolean error;
+    
+    //the scratch context used to number and mark edges, or NULL to use the
+    //context of the calling thread; the writer does not take ownership of it
+    PG_SCRATCH_CONTEXT *scratch;
+};
+
+//the size of the buffer of a PG_WRITER
+#define PG_WRITER_BUFFER_SIZE (1 << 20)
+
+/**
+ * Creates a new writer for the given file. The writer does not take ownership
+ * of the file.
+ * 
+ * This function might return a NULL pointer if insufficient memory was
+ * available.
+ * 
+ * @param file
+ * @param print_header Write the header of the code before the first graph
+ */
+PG_WRITER *new_plane_graph_writer(FILE *file, boolean print_header);
+
+/**
+ * Flushes the writer and frees it. The file is not closed.
+ * @param writer
+ * @return FALSE if the remaining output could not be written
+ */
+boolean free_plane_graph_writer(PG_WRITER *writer);
+
+/**
+ * Writes all buffered output to the file.
+ * @param writer
+ * @return FALSE if the output could not be written
+ */
+boolean flush_plane_graph_writer(PG_WRITER *writer);
+
+/**
+ * Output the planar code of the graph using the writer
+ * @param writer
+ * @param pg
+ * @return FALSE if the graph is too large or the output could not be written
+ */
+boolean write_planar_code_to_writer(PG_WRITER *writer, PLANE_GRAPH *pg);
+
+/**
+ * Output the planar code of the dual of the graph using the writer. The faces
+ * of the graph should be constructed.
+ * @param writer
+ * @param pg
+ * @return FALSE if the graph is too large, its faces have not been constructed
+ *         or the output could not be written
+ */
+boolean write_dual_planar_code_to_writer(PG_WRITER *writer, PLANE_GRAPH *pg);
+
+/**
+ * Output the planar code of the graph using the writer and subdivides each
+ * marked edge with a single vertex.
+ * @param writer
+ * @param pg
+ * @return FALSE if the graph is too large or the output could not be written
+ */
+boolean write_planar_code_marked_edges_subdivided_to_writer(PG_WRITER *writer, PLANE_GRAPH *pg);
+
+/**
+ * Output the edge code of the graph using the writer
+ * @param writer
+ * @param pg
+ * @return FALSE if the graph is too large or the output could not be written
+ */
+boolean write_edge_code_to_writer(PG_WRITER *writer, PLANE_GRAPH *pg);
+
+/**
+ * Output the edge code of the dual of the graph using the writer. The faces
+ * of the graph should be constructed.
+ * @param writer
+ * @param pg
+ * @return FALSE if the graph is too large, its faces have not been constructed
+ *         or the output could not be written
+ */
+boolean write_dual_edge_code_to_writer(PG_WRITER *writer, PLANE_GRAPH *pg);
+
+typedef struct __compressed_planar_code_writer PG_COMPRESSED_WRITER;
+
+/* A writer for compressed planar code. The graphs are collected in blocks of
+ * about PG_COMPRESSED_BLOCK_SIZE bytes, which are written to the file as 
+ * soon as they are full. The index of the blocks is written when the writer
+ * is closed. See planegraphs_input.h for a description of the format.
+ */
+struct __compressed_planar_code_writer {
+    FILE *file;
+    //the number of bytes that have been written to the file
+    uint64_t position;
+    
+    //the current block
+    unsigned char *block;
+    size_t block_length;
+    size_t block_allocated;
+    uint64_t block_graph_count;
+    
+    //the offset and the number of the first graph of each block that was written
+    uint64_t *block_offsets;
+    uint64_t *block_first_graphs;
+    size_t block_count;
+    size_t blocks_allocated;
+    
+    uint64_t graph_count;
+    
+    //TRUE if a write to the file failed
+    boolean error;
+};
+
+/**
+ * Creates a new writer for compressed planar code and writes the header to
+ * the file. The writer does not take ownership of the file.
+ * 
+ * This function might return a NULL pointer if insufficient memory was
+ * available.
+ * 
+ * @param file
+ */
+PG_COMPRESSED_WRITER *new_compressed_planar_code_writer(FILE *file);
+
+/**
+ * Writes the last block and the index of all blocks, and frees the writer.
+ * The file is not closed.
+ * @param writer
+ * @return FALSE if the output could not be written
+ */
+boolean close_compressed_planar_code_writer(PG_COMPRESSED_WRITER *writer);
+
+/**
+ * Output the graph in compressed planar code
+ * @param writer
+ * @param pg
+ * @return FALSE if the graph is too large or the output could not be written
+ */
+boolean write_compressed_planar_code(PG_COMPRESSED_WRITER *writer, PLANE_GRAPH *pg);
+
+/**
+ * Output the graph with the given planar code (as returned by 
+ * read_planar_code) in compressed planar code without decoding it.
+ * @param writer
+ * @param code
+ * @param length the number of entries in the code
+ * @return FALSE if the code is invalid or the output could not be written
+ */
+boolean write_compressed_planar_code_from_code(PG_COMPRESSED_WRITER *writer, unsigned short *code, int length);
+
+/**
+ * Converts a file in planar code to compressed planar code. If the input cannot
+ * be read completely, then the graphs before the error are still converted.
+ * @param in
+ * @param out
+ * @param options the options used to read the planar code
+ * @return FALSE if the input could not be read completely or the output could
+ *         not be written
+ */
+boolean compress_planar_code(FILE *in, FILE *out, PG_INPUT_OPTIONS *options);
+
+/**
+ * Converts a file in compressed planar code to planar code.
+ * @param in
+ * @param out
+ * @param print_header Include the header for planar code
+ * @return FALSE if an error occurred
+ */
+boolean decompress_planar_code(FILE *in, FILE *out, boolean print_header);
+
 #ifdef	__cplusplus
 }
 #endif
@@ -0,0 +1,499 @@
+/*
+ * Main developer: Nico Van Cleemput
+ * 
+ * Copyright (C) 2019 Nico Van Cleemput.
+ * Licensed under the GNU GPL, read the file LICENSE.txt for details.
+ */
+
+#include "planegraphs_pipeline.h"
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+
+typedef struct __pg_batch PG_BATCH;
+
+/* A batch of consecutive codes from the input. */
+struct __pg_batch {
+    long long sequence;
+    int count;
+    
+    //all codes of this batch one after the other: code i is stored in
+    //codes[code_start[i]] up to codes[code_start[i+1]]
+    unsigned short *codes;
+    size_t codes_allocated;
+    size_t *code_start;
+    
+    //the planar code of the accepted graphs
+    unsigned char *output;
+    size_t output_size;
+    size_t output_allocated;
+    
+    unsigned long long accepted;
+    unsigned long long invalid;
+    //TRUE if an accepted graph could not be stored in the output
+    boolean output_error;
+};
+
+typedef struct __pg_work_queue PG_WORK_QUEUE;
+
+/* The batches that are waiting to be handled by a worker. Other workers can
+ * steal batches from this queue when their own queue is empty.
+ */
+struct __pg_work_queue {
+    PG_BATCH **batches;
+    int head;
+    int count;
+    int capacity;
+    pthread_mutex_t lock;
+};
+
+typedef struct __pg_pipeline PG_PIPELINE;
+
+struct __pg_pipeline {
+    int thread_count;
+    int batch_size;
+    PG_INPUT_OPTIONS input_options;
+    PG_GRAPH_PREDICATE predicate;
+    void *data;
+    FILE *out;
+    boolean print_header;
+    
+    PG_WORK_QUEUE *queues;
+    
+    //all batches: a batch is either free, in a queue, being handled or waiting to be written
+    int batch_count;
+    PG_BATCH *batches;
+    PG_BATCH **free_batches;
+    int free_count;
+    //completed[s % batch_count] contains the batch with sequence s once it is handled
+    PG_BATCH **completed;
+    
+    //the fields below are protected by lock
+    pthread_mutex_t lock;
+    pthread_cond_t work_available;
+    pthread_cond_t batch_freed;
+    pthread_cond_t batch_completed;
+    int queued;
+    long long batches_read;
+    boolean reading_done;
+    boolean write_error;
+    //only used by the writer thread until all threads are joined
+    boolean output_error;
+    
+    PG_PIPELINE_STATISTICS statistics;
+};
+
+//----------------BATCHES--------------------
+
+static boolean add_code_to_batch(PG_BATCH *batch, unsigned short *code, int length){
+    size_t used = batch->code_start[batch->count];
+    
+    if(used + length > batch->codes_allocated){
+        size_t new_size = 2 * batch->codes_allocated;
+        if(new_size < used + length){
+            new_size = used + length;
+        }
+        unsigned short *new_codes = (unsigned short *)realloc(batch->codes, new_size * sizeof(unsigned short));
+        if(new_codes == NULL){
+            fprintf(stderr, "Insufficient memory to store codes for this batch.\n");
+            return FALSE;
+        }
+        batch->codes = new_codes;
+        batch->codes_allocated = new_size;
+    }
+    
+    memcpy(batch->codes + used, code, length * sizeof(unsigned short));
+    batch->count++;
+    batch->code_start[batch->count] = used + length;
+    
+    return TRUE;
+}
+
+/**
+ * Appends the planar code to the output of the batch. The code is written
+ * with one byte per entry if possible, and with an unsigned short per entry
+ * otherwise (in the same way as write_planar_code).
+ */
+static boolean append_code_to_output(PG_BATCH *batch, unsigned short *code, size_t length){
+    size_t needed = (code[0] + 1 <= 255) ? length : 1 + length * sizeof(unsigned short);
+    
+    if(batch->output_size + needed > batch->output_allocated){
+        size_t new_size = 2 * batch->output_allocated;
+        if(new_size < batch->output_size + needed){
+            new_size = batch->output_size + needed;
+        }
+        unsigned char *new_output = (unsigned char *)realloc(batch->output, new_size);
+        if(new_output == NULL){
+            fprintf(stderr, "Insufficient memory to store output for this batch.\n");
+            return FALSE;
+        }
+        batch->output = new_output;
+        batch->output_allocated = new_size;
+    }
+    
+    unsigned char *output = batch->output + batch->output_size;
+    if(code[0] + 1 <= 255){
+        for(size_t i = 0; i < length; i++){
+            output[i] = (unsigned char) code[i];
+        }
+    } else {
+        output[0] = 0;
+        memcpy(output + 1, code, length * sizeof(unsigned short));
+    }
+    batch->output_size += needed;
+    
+    return TRUE;
+}
+
+static void handle_batch(PG_PIPELINE *pipeline, PG_BATCH *batch, PLANE_GRAPH *pg){
+    int i;
+    
+    batch->output_size = 0;
+    batch->accepted = batch->invalid = 0;
+    batch->output_error = FALSE;
+    
+    for(i = 0; i < batch->count; i++){
+        unsigned short *code = batch->codes + batch->code_start[i];
+        if(!decode_planar_code_into(pg, code, &(pipeline->input_options))){
+            batch->invalid++;
+        } else if(pipeline->predicate(pg, pipeline->data)){
+            if(append_code_to_output(batch, code, batch->code_start[i+1] - batch->code_start[i])){
+                batch->accepted++;
+            } else {
+                batch->output_error = TRUE;
+            }
+        }
+    }
+}
+
+//----------------WORKERS--------------------
+
+static PG_BATCH *take_batch(PG_WORK_QUEUE *queue){
+    PG_BATCH *batch = NULL;
+    
+    pthread_mutex_lock(&(queue->lock));
+    if(queue->count){
+        batch = queue->batches[queue->head];
+        queue->head = (queue->head + 1) % queue->capacity;
+        queue->count--;
+    }
+    pthread_mutex_unlock(&(queue->lock));
+    
+    return batch;
+}
+
+static void put_batch(PG_WORK_QUEUE *queue, PG_BATCH *batch){
+    pthread_mutex_lock(&(queue->lock));
+    queue->batches[(queue->head + queue->count) % queue->capacity] = batch;
+    queue->count++;
+    pthread_mutex_unlock(&(queue->lock));
+}
+
+typedef struct __pg_worker_data {
+    PG_PIPELINE *pipeline;
+    int id;
+} PG_WORKER_DATA;
+
+static void *run_worker(void *argument){
+    PG_WORKER_DATA *worker = (PG_WORKER_DATA *)argument;
+    PG_PIPELINE *pipeline = worker->pipeline;
+    
+    //the graph is reused for all graphs handled by this worker, and grows when needed
+    PLANE_GRAPH *pg = new_plane_graph(100, 0);
+    
+    while(TRUE){
+        pthread_mutex_lock(&(pipeline->lock));
+        while(pipeline->queued == 0 && !pipeline->reading_done){
+            pthread_cond_wait(&(pipeline->work_available), &(pipeline->lock));
+        }
+        if(pipeline->queued == 0){
+            pthread_mutex_unlock(&(pipeline->lock));
+            break;
+        }
+        //claim one of the queued batches
+        pipeline->queued--;
+        pthread_mutex_unlock(&(pipeline->lock));
+        
+        //first look in our own queue, and then steal from the others
+        PG_BATCH *batch = NULL;
+        for(int i = 0; batch == NULL; i = (i + 1) % pipeline->thread_count){
+            batch = take_batch(pipeline->queues + (worker->id + i) % pipeline->thread_count);
+        }
+        
+        if(pg == NULL){
+            //the graphs of this batch cannot be handled
+            batch->output_size = 0;
+            batch->accepted = 0;
+            batch->invalid = 0;
+            batch->output_error = TRUE;
+        } else {
+            handle_batch(pipeline, batch, pg);
+        }
+        
+        pthread_mutex_lock(&(pipeline->lock));
+        pipeline->completed[batch->sequence % pipeline->batch_count] = batch;
+        pthread_cond_broadcast(&(pipeline->batch_completed));
+        pthread_mutex_unlock(&(pipeline->lock));
+    }
+    
+    if(pg != NULL){
+        free_plane_graph(pg);
+    }
+    
+    return NULL;
+}
+
+//----------------WRITER--------------------
+
+static void *run_writer(void *argument){
+    PG_PIPELINE *pipeline = (PG_PIPELINE *)argument;
+    long long next = 0;
+    
+    if(pipeline->print_header){
+        if(fputs(">>planar_code<<", pipeline->out) == EOF){
+            pipeline->write_error = TRUE;
+        }
+    }
+    
+    while(TRUE){
+        PG_BATCH **slot = pipeline->completed + (next % pipeline->batch_count);
+        
+        pthread_mutex_lock(&(pipeline->lock));
+        while(*slot == NULL && !(pipeline->reading_done && next == pipeline->batches_read)){
+            pthread_cond_wait(&(pipeline->batch_completed), &(pipeline->lock));
+        }
+        if(*slot == NULL){
+            pthread_mutex_unlock(&(pipeline->lock));
+            break;
+        }
+        PG_BATCH *batch = *slot;
+        *slot = NULL;
+        pthread_mutex_unlock(&(pipeline->lock));
+        
+        if(batch->output_size && 
+                fwrite(batch->output, sizeof(unsigned char), batch->output_size, pipeline->out) != batch->output_size){
+            pipeline->write_error = TRUE;
+        }
+        if(batch->output_error){
+            pipeline->output_error = TRUE;
+        }
+        pipeline->statistics.read += batch->count;
+        pipeline->statistics.accepted += batch->accepted;
+        pipeline->statistics.invalid += batch->invalid;
+        
+        pthread_mutex_lock(&(pipeline->lock));
+        pipeline->free_batches[pipeline->free_count++] = batch;
+        pthread_cond_signal(&(pipeline->batch_freed));
+        pthread_mutex_unlock(&(pipeline->lock));
+        
+        next++;
+    }
+    
+    return NULL;
+}
+
+//----------------PIPELINE--------------------
+
+static void free_pipeline(PG_PIPELINE *pipeline){
+    int i;
+    
+    if(pipeline->batches != NULL){
+        for(i = 0; i < pipeline->batch_count; i++){
+            free(pipeline->batches[i].codes);
+            free(pipeline->batches[i].code_start);
+            free(pipeline->batches[i].output);
+        }
+    }
+    if(pipeline->queues != NULL){
+        for(i = 0; i < pipeline->thread_count; i++){
+            free(pipeline->queues[i].batches);
+            pthread_mutex_destroy(&(pipeline->queues[i].lock));
+        }
+    }
+    free(pipeline->queues);
+    free(pipeline->batches);
+    free(pipeline->free_batches);
+    free(pipeline->completed);
+    pthread_mutex_destroy(&(pipeline->lock));
+    pthread_cond_destroy(&(pipeline->work_available));
+    pthread_cond_destroy(&(pipeline->batch_freed));
+    pthread_cond_destroy(&(pipeline->batch_completed));
+}
+
+static boolean initialise_pipeline(PG_PIPELINE *pipeline, PG_PIPELINE_OPTIONS *options){
+    int i;
+    
+    pipeline->thread_count = options->thread_count > 0 ? options->thread_count : 1;
+    pipeline->batch_size = options->batch_size > 0 ? options->batch_size : 1;
+    pipeline->batch_count = pipeline->thread_count * (options->batches_per_thread > 0 ? options->batches_per_thread : 1);
+    pipeline->print_header = options->print_header;
+    
+    pthread_mutex_init(&(pipeline->lock), NULL);
+    pthread_cond_init(&(pipeline->work_available), NULL);
+    pthread_cond_init(&(pipeline->batch_freed), NULL);
+    pthread_cond_init(&(pipeline->batch_completed), NULL);
+    pipeline->queued = 0;
+    pipeline->batches_read = 0;
+    pipeline->reading_done = FALSE;
+    pipeline->write_error = FALSE;
+    pipeline->output_error = FALSE;
+    pipeline->statistics.read = pipeline->statistics.accepted = pipeline->statistics.invalid = 0;
+    
+    pipeline->queues = (PG_WORK_QUEUE *)calloc(pipeline->thread_count, sizeof(PG_WORK_QUEUE));
+    pipeline->batches = (PG_BATCH *)calloc(pipeline->batch_count, sizeof(PG_BATCH));
+    pipeline->free_batches = (PG_BATCH **)malloc(sizeof(PG_BATCH *) * pipeline->batch_count);
+    pipeline->completed = (PG_BATCH **)calloc(pipeline->batch_count, sizeof(PG_BATCH *));
+    if(pipeline->queues == NULL || pipeline->batches == NULL || 
+            pipeline->free_batches == NULL || pipeline->completed == NULL){
+        fprintf(stderr, "Insufficient memory for pipeline.\n");
+        return FALSE;
+    }
+    
+    for(i = 0; i < pipeline->thread_count; i++){
+        pthread_mutex_init(&(pipeline->queues[i].lock), NULL);
+        //a queue never contains more than all batches
+        pipeline->queues[i].capacity = pipeline->batch_count;
+        pipeline->queues[i].batches = (PG_BATCH **)malloc(sizeof(PG_BATCH *) * pipeline->batch_count);
+        if(pipeline->queues[i].batches == NULL){
+            fprintf(stderr, "Insufficient memory for pipeline.\n");
+            return FALSE;
+        }
+    }
+    
+    for(i = 0; i < pipeline->batch_count; i++){
+        PG_BATCH *batch = pipeline->batches + i;
+        batch->code_start = (size_t *)malloc(sizeof(size_t) * (pipeline->batch_size + 1));
+        batch->codes_allocated = pipeline->input_options.initial_code_length * (size_t) pipeline->batch_size;
+        batch->codes = (unsigned short *)malloc(sizeof(unsigned short) * batch->codes_allocated);
+        if(batch->code_start == NULL || batch->codes == NULL){
+            fprintf(stderr, "Insufficient memory for pipeline.\n");
+            return FALSE;
+        }
+        pipeline->free_batches[i] = batch;
+    }
+    pipeline->free_count = pipeline->batch_count;
+    
+    return TRUE;
+}
+
+boolean filter_planar_code(FILE *in, FILE *out, PG_INPUT_OPTIONS *input_options,
+                           PG_GRAPH_PREDICATE predicate, void *data,
+                           PG_PIPELINE_OPTIONS *options, PG_PIPELINE_STATISTICS *statistics){
+    int i, started_workers = 0;
+    boolean writer_started = FALSE, success = TRUE;
+    PG_PIPELINE pipeline;
+    pthread_t writer;
+    
+    memset(&pipeline, 0, sizeof(PG_PIPELINE));
+    pipeline.input_options = *input_options;
+    pipeline.predicate = predicate;
+    pipeline.data = data;
+    pipeline.out = out;
+    
+    PG_READER *reader = new_planar_code_reader(in, input_options);
+    pthread_t *workers = (pthread_t *)malloc(sizeof(pthread_t) * (options->thread_count > 0 ? options->thread_count : 1));
+    PG_WORKER_DATA *worker_data = (PG_WORKER_DATA *)malloc(sizeof(PG_WORKER_DATA) * (options->thread_count > 0 ? options->thread_count : 1));
+    
+    if(reader == NULL || workers == NULL || worker_data == NULL || !initialise_pipeline(&pipeline, options)){
+        success = FALSE;
+    }
+    
+    if(success){
+        for(i = 0; i < pipeline.thread_count; i++){
+            worker_data[i].pipeline = &pipeline;
+            worker_data[i].id = i;
+            if(pthread_create(workers + i, NULL, run_worker, worker_data + i)){
+                fprintf(stderr, "Could not start worker thread.\n");
+                success = FALSE;
+                break;
+            }
+            started_workers++;
+        }
+    }
+    
+    if(success){
+        if(pthread_create(&writer, NULL, run_writer, &pipeline)){
+            fprintf(stderr, "Could not start writer thread.\n");
+            success = FALSE;
+        } else {
+            writer_started = TRUE;
+        }
+    }
+    
+    //read the input on this thread
+    boolean end_of_input = !success, read_error = FALSE;
+    while(!end_of_input){
+        pthread_mutex_lock(&(pipeline.lock));
+        while(pipeline.free_count == 0){
+            pthread_cond_wait(&(pipeline.batch_freed), &(pipeline.lock));
+        }
+        PG_BATCH *batch = pipeline.free_batches[--pipeline.free_count];
+        pthread_mutex_unlock(&(pipeline.lock));
+        
+        batch->count = 0;
+        batch->code_start[0] = 0;
+        while(batch->count < pipeline.batch_size){
+            int length = read_planar_code_into_reader_buffer(reader);
+            if(length == 0){
+                read_error = reader->error;
+                end_of_input = TRUE;
+                break;
+            }
+            if(!add_code_to_batch(batch, reader->code, length)){
+                read_error = TRUE;
+                end_of_input = TRUE;
+                break;
+            }
+        }
+        
+        pthread_mutex_lock(&(pipeline.lock));
+        if(batch->count == 0){
+            pipeline.free_batches[pipeline.free_count++] = batch;
+        } else {
+            batch->sequence = pipeline.batches_read++;
+            put_batch(pipeline.queues + (batch->sequence % pipeline.thread_count), batch);
+            pipeline.queued++;
+            pthread_cond_signal(&(pipeline.work_available));
+        }
+        pthread_mutex_unlock(&(pipeline.lock));
+    }
+    
+    pthread_mutex_lock(&(pipeline.lock));
+    pipeline.reading_done = TRUE;
+    pthread_cond_broadcast(&(pipeline.work_available));
+    pthread_cond_broadcast(&(pipeline.batch_completed));
+    pthread_mutex_unlock(&(pipeline.lock));
+    
+    for(i = 0; i < started_workers; i++){
+        pthread_join(workers[i], NULL);
+    }
+    if(writer_started){
+        pthread_join(writer, NULL);
+    }
+    
+    if(read_error){
+        fprintf(stderr, "The input could not be read completely.\n");
+        success = FALSE;
+    }
+    if(pipeline.output_error){
+        fprintf(stderr, "Not all accepted graphs could be written.\n");
+        success = FALSE;
+    }
+    if(pipeline.write_error){
+        fprintf(stderr, "fwrite() failed.\n");
+        success = FALSE;
+    }
+    
+    if(statistics != NULL){
+        *statistics = pipeline.statistics;
+    }
+    
+    free_pipeline(&pipeline);
+    free(workers);
+    free(worker_data);
+    if(reader != NULL){
+        free_planar_code_reader(reader);
+    }
+    
+    return success;
+}
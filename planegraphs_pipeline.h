@@ -0,0 +1,81 @@
+/*
+ * Main developer: Nico Van Cleemput
+ * 
+ * Copyright (C) 2019 Nico Van Cleemput.
+ * Licensed under the GNU GPL, read the file LICENSE.txt for details.
+ */
+
+#ifndef PLANEGRAPH_PIPELINE_H
+#define PLANEGRAPH_PIPELINE_H
+
+#include "planegraphs_base.h"
+#include "planegraphs_input.h"
+#include <stdio.h>
+
+#ifdef	__cplusplus
+extern "C" {
+#endif
+
+    /* A predicate decides whether a graph is accepted by the filter. The 
+     * predicate is called from several threads at the same time, so it should
+     * not modify data other than the graph it is given.
+     */
+    typedef boolean (*PG_GRAPH_PREDICATE)(PLANE_GRAPH *pg, void *data);
+    
+    typedef struct __plane_graph_pipeline_options PG_PIPELINE_OPTIONS;
+    
+    struct __plane_graph_pipeline_options {
+        //the number of threads that evaluate the predicate
+        int thread_count;
+        
+        //the number of graphs that are handed to a thread at once
+        int batch_size;
+        
+        //the maximum number of batches per thread that are read ahead
+        int batches_per_thread;
+        
+        //write a planar code header to the output
+        boolean print_header;
+    };
+    
+#define DEFAULT_PG_PIPELINE_OPTIONS(options) PG_PIPELINE_OPTIONS options = {4, 1024, 4, TRUE}
+    
+    typedef struct __plane_graph_pipeline_statistics PG_PIPELINE_STATISTICS;
+    
+    struct __plane_graph_pipeline_statistics {
+        unsigned long long read;
+        unsigned long long accepted;
+        //the number of codes that could not be decoded
+        unsigned long long invalid;
+    };
+    
+    /**
+     * Reads all graphs in planar code from in, and writes the graphs that are
+     * accepted by the predicate in planar code to out, in the same order as
+     * they were read. The file is read by one thread, the predicate is
+     * evaluated by a pool of worker threads which steal batches from each
+     * other when they run out of work, and the accepted graphs are written by
+     * one thread.
+     * 
+     * @param in
+     * @param out
+     * @param input_options the options used to read and decode the graphs
+     * @param predicate
+     * @param data passed to each call of the predicate
+     * @param options
+     * @param statistics if not NULL, the number of graphs that were read, 
+     *                   accepted and could not be decoded is stored here
+     * @return FALSE if the pipeline could not be started, if the input could
+     *         not be read completely (because of a read error, a truncated or
+     *         invalid stream or insufficient memory), or if an accepted graph
+     *         could not be written
+     */
+    boolean filter_planar_code(FILE *in, FILE *out, PG_INPUT_OPTIONS *input_options,
+                               PG_GRAPH_PREDICATE predicate, void *data,
+                               PG_PIPELINE_OPTIONS *options, PG_PIPELINE_STATISTICS *statistics);
+
+#ifdef	__cplusplus
+}
+#endif
+
+#endif //PLANEGRAPH_PIPELINE_H
@@ -0,0 +1,99 @@
+/*
+ * Main developer: Nico Van Cleemput
+ *
+ * Copyright (C) 2019 Nico Van Cleemput.
+ * Licensed under the GNU GPL, read the file LICENSE.txt for details.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <pthread.h>
+#include "planegraphs_scratch.h"
+
+PG_SCRATCH_CONTEXT *new_scratch_context(){
+    PG_SCRATCH_CONTEXT *scratch = (PG_SCRATCH_CONTEXT *)calloc(1, sizeof(PG_SCRATCH_CONTEXT));
+    if(scratch == NULL){
+        fprintf(stderr, "Insufficient memory for scratch context -- exiting!\n");
+        exit(EXIT_FAILURE);
+    }
+    scratch->epoch = 1;
+    return scratch;
+}
+
+void free_scratch_context(PG_SCRATCH_CONTEXT *scratch){
+    free(scratch->vertex_marks);
+    free(scratch->edge_marks);
+    free(scratch->face_marks);
+    free(scratch->vertex_index);
+    free(scratch->edge_index);
+    free(scratch->face_index);
+    free(scratch);
+}
+
+/**
+ * Replaces the marks and the numbers of one kind of elements by larger arrays
+ * if they do not have room for the given number of elements. The new marks
+ * are 0, which is never a valid epoch.
+ */
+static void grow_scratch_arrays(unsigned int **marks, int **index, int *capacity, int needed){
+    if(needed <= *capacity){
+        return;
+    }
+    free(*marks);
+    free(*index);
+    *marks = (unsigned int *)calloc(needed, sizeof(unsigned int));
+    *index = (int *)malloc(sizeof(int) * needed);
+    if(*marks == NULL || *index == NULL){
+        fprintf(stderr, "Insufficient memory for scratch context -- exiting!\n");
+        exit(EXIT_FAILURE);
+    }
+    *capacity = needed;
+}
+
+void prepare_scratch_context(PG_SCRATCH_CONTEXT *scratch, PLANE_GRAPH *pg){
+    grow_scratch_arrays(&(scratch->vertex_marks), &(scratch->vertex_index),
+            &(scratch->vertex_capacity), pg->nv);
+    grow_scratch_arrays(&(scratch->edge_marks), &(scratch->edge_index),
+            &(scratch->edge_capacity), pg->ne);
+    grow_scratch_arrays(&(scratch->face_marks), &(scratch->face_index),
+            &(scratch->face_capacity), pg->faces_constructed ? pg->nf : 0);
+
+    if(scratch->epoch == UINT_MAX){
+        //the old stamps could be mistaken for new ones, so they are cleared
+        memset(scratch->vertex_marks, 0, sizeof(unsigned int) * scratch->vertex_capacity);
+        memset(scratch->edge_marks, 0, sizeof(unsigned int) * scratch->edge_capacity);
+        memset(scratch->face_marks, 0, sizeof(unsigned int) * scratch->face_capacity);
+        scratch->epoch = 0;
+        PG_STATS_ADD(PG_STATS_MARK_WRAPS, 1);
+    }
+    scratch->epoch++;
+}
+
+static pthread_key_t thread_scratch_key;
+static pthread_once_t thread_scratch_key_once = PTHREAD_ONCE_INIT;
+
+static void free_thread_scratch_context(void *scratch){
+    free_scratch_context((PG_SCRATCH_CONTEXT *)scratch);
+}
+
+static void create_thread_scratch_key(){
+    if(pthread_key_create(&thread_scratch_key, free_thread_scratch_context)){
+        fprintf(stderr, "Could not create thread-local scratch context -- exiting!\n");
+        exit(EXIT_FAILURE);
+    }
+}
+
+PG_SCRATCH_CONTEXT *get_thread_scratch_context(){
+    pthread_once(&thread_scratch_key_once, create_thread_scratch_key);
+    PG_SCRATCH_CONTEXT *scratch = (PG_SCRATCH_CONTEXT *)pthread_getspecific(thread_scratch_key);
+    if(scratch == NULL){
+        scratch = new_scratch_context();
+        if(pthread_setspecific(thread_scratch_key, scratch)){
+            fprintf(stderr, "Could not store thread-local scratch context -- exiting!\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+    return scratch;
+}
@@ -0,0 +1,79 @@
+/*
+ * Main developer: Nico Van Cleemput
+ *
+ * Copyright (C) 2019 Nico Van Cleemput.
+ * Licensed under the GNU GPL, read the file LICENSE.txt for details.
+ */
+
+/* Scratch contexts store the temporary marks and numbers of the vertices,
+ * edges and faces of a graph outside of the graph. Algorithms that use a
+ * scratch context instead of the mark and index fields of the edges do not
+ * modify the graph, so several threads can analyse the same graph at the same
+ * time as long as each thread uses its own context. The faces of a shared
+ * graph should be constructed before it is shared: the functions that need the
+ * faces fail instead of constructing them.
+ *
+ * An element is marked if its stamp is equal to the current epoch of the
+ * context, so all marks are cleared in constant time by starting a new epoch.
+ */
+
+#ifndef PLANEGRAPH_SCRATCH_H
+#define PLANEGRAPH_SCRATCH_H
+
+#include "planegraphs_base.h"
+
+typedef struct __pg_scratch_context PG_SCRATCH_CONTEXT;
+
+struct __pg_scratch_context {
+    unsigned int epoch;
+
+    //the number of vertices, edges and faces for which there is room
+    int vertex_capacity;
+    int edge_capacity;
+    int face_capacity;
+
+    unsigned int *vertex_marks;
+    unsigned int *edge_marks;
+    unsigned int *face_marks;
+
+    //numbers that can be associated with the elements, these are not cleared
+    int *vertex_index;
+    int *edge_index;
+    int *face_index;
+};
+
+/**
+ * Creates an empty scratch context. A context can be reused for graphs of any
+ * size, but can only be used by one thread at a time.
+ */
+PG_SCRATCH_CONTEXT *new_scratch_context();
+
+void free_scratch_context(PG_SCRATCH_CONTEXT *scratch);
+
+/**
+ * Makes sure the context has room for all vertices, edges and faces of the
+ * graph, and clears all marks.
+ * @param scratch
+ * @param pg
+ */
+void prepare_scratch_context(PG_SCRATCH_CONTEXT *scratch, PLANE_GRAPH *pg);
+
+/**
+ * Returns the scratch context of the calling thread. This context is created
+ * the first time it is requested by a thread, and is freed when that thread
+ * exits. It is used by the functions that accept a context when none is given.
+ */
+PG_SCRATCH_CONTEXT *get_thread_scratch_context();
+
+#define SCRATCH_MARK_VERTEX(s, v) (s)->vertex_marks[v] = (s)->epoch
+#define SCRATCH_UNMARK_VERTEX(s, v) (s)->vertex_marks[v] = 0
+#define SCRATCH_ISMARKED_VERTEX(s, v) ((s)->vertex_marks[v] == (s)->epoch)
+#define SCRATCH_MARK_EDGE(s, pg, e) (s)->edge_marks[(e) - (pg)->edges] = (s)->epoch
+#define SCRATCH_UNMARK_EDGE(s, pg, e) (s)->edge_marks[(e) - (pg)->edges] = 0
+#define SCRATCH_ISMARKED_EDGE(s, pg, e) ((s)->edge_marks[(e) - (pg)->edges] == (s)->epoch)
+#define SCRATCH_MARK_FACE(s, f) (s)->face_marks[f] = (s)->epoch
+#define SCRATCH_UNMARK_FACE(s, f) (s)->face_marks[f] = 0
+#define SCRATCH_ISMARKED_FACE(s, f) ((s)->face_marks[f] == (s)->epoch)
+#define SCRATCH_EDGE_INDEX(s, pg, e) (s)->edge_index[(e) - (pg)->edges]
+
+#endif //PLANEGRAPH_SCRATCH_H
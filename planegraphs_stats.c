@@ -0,0 +1,232 @@
+/*
+ * Main developer: Nico Van Cleemput
+ *
+ * Copyright (C) 2019 Nico Van Cleemput.
+ * Licensed under the GNU GPL, read the file LICENSE.txt for details.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+#include "planegraphs_stats.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+/* The counters of one thread. They are only changed by their own thread, but
+ * they are read by the thread that takes a snapshot, so they are accessed with
+ * relaxed atomic loads and stores. These are ordinary loads and stores on
+ * common processors.
+ */
+typedef struct __pg_thread_stats PG_THREAD_STATS;
+
+struct __pg_thread_stats {
+    uint64_t counters[PG_STATS_COUNTER_COUNT];
+    uint64_t phase_calls[PG_STATS_PHASE_COUNT];
+    uint64_t phase_ticks[PG_STATS_PHASE_COUNT];
+
+    PG_THREAD_STATS *next;
+};
+
+#define STATS_LOAD(x) __atomic_load_n(&(x), __ATOMIC_RELAXED)
+#define STATS_STORE(x, value) __atomic_store_n(&(x), value, __ATOMIC_RELAXED)
+#define STATS_INCREASE(x, amount) STATS_STORE(x, STATS_LOAD(x) + (amount))
+
+static const char *counter_names[PG_STATS_COUNTER_COUNT] = {
+    "decoded bytes",
+    "starting edges tried",
+    "certificate early exits",
+    "BFS nodes visited",
+    "mark wrap-arounds"
+};
+
+static const char *phase_names[PG_STATS_PHASE_COUNT] = {
+    "decode",
+    "construct faces",
+    "automorphisms",
+    "shortest cycle"
+};
+
+//the counters of the running threads, and the sum of those of exited threads
+static pthread_mutex_t stats_mutex = PTHREAD_MUTEX_INITIALIZER;
+static PG_THREAD_STATS *live_threads = NULL;
+static PG_THREAD_STATS exited_threads;
+static int exited_thread_count = 0;
+
+static pthread_key_t thread_stats_key;
+static pthread_once_t thread_stats_key_once = PTHREAD_ONCE_INIT;
+
+/**
+ * Adds the counters of source to those of target.
+ */
+static void add_thread_stats(PG_THREAD_STATS *target, PG_THREAD_STATS *source){
+    int i;
+    for(i = 0; i < PG_STATS_COUNTER_COUNT; i++){
+        STATS_INCREASE(target->counters[i], STATS_LOAD(source->counters[i]));
+    }
+    for(i = 0; i < PG_STATS_PHASE_COUNT; i++){
+        STATS_INCREASE(target->phase_calls[i], STATS_LOAD(source->phase_calls[i]));
+        STATS_INCREASE(target->phase_ticks[i], STATS_LOAD(source->phase_ticks[i]));
+    }
+}
+
+static void clear_thread_stats(PG_THREAD_STATS *stats){
+    int i;
+    for(i = 0; i < PG_STATS_COUNTER_COUNT; i++){
+        STATS_STORE(stats->counters[i], 0);
+    }
+    for(i = 0; i < PG_STATS_PHASE_COUNT; i++){
+        STATS_STORE(stats->phase_calls[i], 0);
+        STATS_STORE(stats->phase_ticks[i], 0);
+    }
+}
+
+/**
+ * Moves the counters of an exiting thread to the counters of the exited threads.
+ */
+static void free_thread_stats(void *argument){
+    PG_THREAD_STATS *stats = (PG_THREAD_STATS *)argument;
+    pthread_mutex_lock(&stats_mutex);
+    PG_THREAD_STATS **link = &live_threads;
+    while(*link != stats){
+        link = &((*link)->next);
+    }
+    *link = stats->next;
+    add_thread_stats(&exited_threads, stats);
+    exited_thread_count++;
+    pthread_mutex_unlock(&stats_mutex);
+    free(stats);
+}
+
+static void create_thread_stats_key(){
+    if(pthread_key_create(&thread_stats_key, free_thread_stats)){
+        fprintf(stderr, "Could not create thread-local statistics -- exiting!\n");
+        exit(EXIT_FAILURE);
+    }
+}
+
+static PG_THREAD_STATS *get_thread_stats(){
+    pthread_once(&thread_stats_key_once, create_thread_stats_key);
+    PG_THREAD_STATS *stats = (PG_THREAD_STATS *)pthread_getspecific(thread_stats_key);
+    if(stats == NULL){
+        stats = (PG_THREAD_STATS *)calloc(1, sizeof(PG_THREAD_STATS));
+        if(stats == NULL){
+            fprintf(stderr, "Insufficient memory for statistics -- exiting!\n");
+            exit(EXIT_FAILURE);
+        }
+        if(pthread_setspecific(thread_stats_key, stats)){
+            fprintf(stderr, "Could not store thread-local statistics -- exiting!\n");
+            exit(EXIT_FAILURE);
+        }
+        pthread_mutex_lock(&stats_mutex);
+        stats->next = live_threads;
+        live_threads = stats;
+        pthread_mutex_unlock(&stats_mutex);
+    }
+    return stats;
+}
+
+static void store_snapshot(PG_STATS_SNAPSHOT *snapshot, PG_THREAD_STATS *stats){
+    memcpy(snapshot->counters, stats->counters, sizeof(snapshot->counters));
+    memcpy(snapshot->phase_calls, stats->phase_calls, sizeof(snapshot->phase_calls));
+    memcpy(snapshot->phase_ticks, stats->phase_ticks, sizeof(snapshot->phase_ticks));
+}
+
+int plane_graph_stats_enabled(){
+#ifdef PG_STATS
+    return 1;
+#else
+    return 0;
+#endif
+}
+
+void get_plane_graph_stats(PG_STATS_SNAPSHOT *snapshot){
+    PG_THREAD_STATS sum;
+    memset(&sum, 0, sizeof(PG_THREAD_STATS));
+    pthread_mutex_lock(&stats_mutex);
+    add_thread_stats(&sum, &exited_threads);
+    snapshot->thread_count = exited_thread_count;
+    PG_THREAD_STATS *stats = live_threads;
+    while(stats != NULL){
+        add_thread_stats(&sum, stats);
+        snapshot->thread_count++;
+        stats = stats->next;
+    }
+    pthread_mutex_unlock(&stats_mutex);
+    store_snapshot(snapshot, &sum);
+}
+
+void get_thread_plane_graph_stats(PG_STATS_SNAPSHOT *snapshot){
+    PG_THREAD_STATS sum;
+    memset(&sum, 0, sizeof(PG_THREAD_STATS));
+    if(plane_graph_stats_enabled()){
+        add_thread_stats(&sum, get_thread_stats());
+    }
+    store_snapshot(snapshot, &sum);
+    snapshot->thread_count = 1;
+}
+
+void reset_plane_graph_stats(){
+    pthread_mutex_lock(&stats_mutex);
+    clear_thread_stats(&exited_threads);
+    exited_thread_count = 0;
+    PG_THREAD_STATS *stats = live_threads;
+    while(stats != NULL){
+        clear_thread_stats(stats);
+        stats = stats->next;
+    }
+    pthread_mutex_unlock(&stats_mutex);
+}
+
+const char *get_plane_graph_stats_counter_name(PG_STATS_COUNTER counter){
+    return counter_names[counter];
+}
+
+const char *get_plane_graph_stats_phase_name(PG_STATS_PHASE phase){
+    return phase_names[phase];
+}
+
+void print_plane_graph_stats(FILE *f, PG_STATS_SNAPSHOT *snapshot){
+    int i;
+    if(!plane_graph_stats_enabled()){
+        fprintf(f, "Statistics are not available: compile with PG_STATS defined.\n");
+        return;
+    }
+    fprintf(f, "Statistics over %d thread%s\n", snapshot->thread_count,
+            snapshot->thread_count == 1 ? "" : "s");
+    for(i = 0; i < PG_STATS_COUNTER_COUNT; i++){
+        fprintf(f, "  %-25s %20llu\n", counter_names[i], (unsigned long long)snapshot->counters[i]);
+    }
+    for(i = 0; i < PG_STATS_PHASE_COUNT; i++){
+        fprintf(f, "  %-25s %20llu calls %20llu ticks", phase_names[i],
+                (unsigned long long)snapshot->phase_calls[i], (unsigned long long)snapshot->phase_ticks[i]);
+        if(snapshot->phase_calls[i]){
+            fprintf(f, " %14.1f ticks/call", (double)snapshot->phase_ticks[i] / snapshot->phase_calls[i]);
+        }
+        fprintf(f, "\n");
+    }
+}
+
+uint64_t read_plane_graph_stats_clock(){
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000000u + now.tv_nsec;
+#endif
+}
+
+void add_plane_graph_stats_count(PG_STATS_COUNTER counter, uint64_t amount){
+    PG_THREAD_STATS *stats = get_thread_stats();
+    STATS_INCREASE(stats->counters[counter], amount);
+}
+
+void add_plane_graph_stats_phase(PG_STATS_PHASE phase, uint64_t ticks){
+    PG_THREAD_STATS *stats = get_thread_stats();
+    STATS_INCREASE(stats->phase_calls[phase], 1);
+    STATS_INCREASE(stats->phase_ticks[phase], ticks);
+}
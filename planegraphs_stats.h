@@ -0,0 +1,120 @@
+/*
+ * Main developer: Nico Van Cleemput
+ *
+ * Copyright (C) 2019 Nico Van Cleemput.
+ * Licensed under the GNU GPL, read the file LICENSE.txt for details.
+ */
+
+/* Optional instrumentation of the hot paths of the library. The counters and
+ * timers are only updated if the library is compiled with PG_STATS defined
+ * (configure with -DPLANEGRAPH_STATS=ON). Otherwise the macros below expand to
+ * nothing and the snapshots only contain zeros.
+ *
+ * Each thread updates its own counters, so the instrumentation does not need
+ * any locking on the hot paths. A snapshot adds up the counters of all threads,
+ * including the threads that have already exited.
+ */
+
+#ifndef PLANEGRAPH_STATS_H
+#define PLANEGRAPH_STATS_H
+
+#include <stdio.h>
+#include <stdint.h>
+
+/* The events that are counted. */
+typedef enum {
+    //the number of bytes of planar code that were decoded
+    PG_STATS_DECODED_BYTES,
+    //the starting edges for which a certificate was compared to the best one
+    PG_STATS_STARTING_EDGES_TRIED,
+    //the comparisons of certificates that stopped before the end of the certificate
+    PG_STATS_CERTIFICATE_EARLY_EXITS,
+    //the vertices expanded by the breadth-first searches for short cycles
+    PG_STATS_BFS_NODES_VISITED,
+    //the times all marks had to be cleared because the mark value or the epoch
+    //of a scratch context overflowed
+    PG_STATS_MARK_WRAPS,
+    PG_STATS_COUNTER_COUNT
+} PG_STATS_COUNTER;
+
+/* The timed phases. A phase can contain another phase, e.g., decoding a graph
+ * includes constructing its faces if that is requested.
+ */
+typedef enum {
+    PG_STATS_PHASE_DECODE,
+    PG_STATS_PHASE_CONSTRUCT_FACES,
+    PG_STATS_PHASE_AUTOMORPHISMS,
+    PG_STATS_PHASE_SHORTEST_CYCLE,
+    PG_STATS_PHASE_COUNT
+} PG_STATS_PHASE;
+
+typedef struct __pg_stats_snapshot PG_STATS_SNAPSHOT;
+
+struct __pg_stats_snapshot {
+    uint64_t counters[PG_STATS_COUNTER_COUNT];
+
+    //the number of times each phase was entered, and the total number of
+    //ticks of the cycle counter spent in it
+    uint64_t phase_calls[PG_STATS_PHASE_COUNT];
+    uint64_t phase_ticks[PG_STATS_PHASE_COUNT];
+
+    //the number of threads whose counters are included
+    int thread_count;
+};
+
+/**
+ * Returns 1 if the library was compiled with instrumentation, and 0 otherwise.
+ */
+int plane_graph_stats_enabled();
+
+/**
+ * Stores the sum of the counters of all threads in the snapshot.
+ * @param snapshot
+ */
+void get_plane_graph_stats(PG_STATS_SNAPSHOT *snapshot);
+
+/**
+ * Stores the counters of the calling thread in the snapshot.
+ * @param snapshot
+ */
+void get_thread_plane_graph_stats(PG_STATS_SNAPSHOT *snapshot);
+
+/**
+ * Sets the counters of all threads to zero. Events that happen in other
+ * threads while the counters are reset can be lost.
+ */
+void reset_plane_graph_stats();
+
+const char *get_plane_graph_stats_counter_name(PG_STATS_COUNTER counter);
+
+const char *get_plane_graph_stats_phase_name(PG_STATS_PHASE phase);
+
+/**
+ * Writes a human readable overview of the snapshot.
+ * @param f
+ * @param snapshot
+ */
+void print_plane_graph_stats(FILE *f, PG_STATS_SNAPSHOT *snapshot);
+
+/**
+ * Returns the current value of the cycle counter of the processor, or a
+ * clock in nanoseconds on processors without an accessible cycle counter.
+ */
+uint64_t read_plane_graph_stats_clock();
+
+void add_plane_graph_stats_count(PG_STATS_COUNTER counter, uint64_t amount);
+
+void add_plane_graph_stats_phase(PG_STATS_PHASE phase, uint64_t ticks);
+
+#ifdef PG_STATS
+#define PG_STATS_ADD(counter, amount) add_plane_graph_stats_count(counter, amount)
+#define PG_STATS_START(phase) uint64_t pg_stats_start_##phase = read_plane_graph_stats_clock()
+#define PG_STATS_STOP(phase) \
+        add_plane_graph_stats_phase(phase, read_plane_graph_stats_clock() - pg_stats_start_##phase)
+#else
+#define PG_STATS_ADD(counter, amount)
+#define PG_STATS_START(phase)
+#define PG_STATS_STOP(phase)
+#endif
+
+#endif //PLANEGRAPH_STATS_H